@@ -0,0 +1,57 @@
+#ifndef _bench_h
+#define _bench_h
+
+#include <avr/pgmspace.h>
+#include "constants.h"
+#include "input.h"
+
+/*
+  Recorrido fijo de sto_level_1 usado por la escena BENCH (BENCH_SIMAVR).
+
+  La escena juega BENCH_FRAMES cuadros, uno por paso de simulación y sin esperar al reloj, con los
+  botones de bench_script: cada tramo mantiene una máscara de BUTTONS durante varios cuadros y el
+  recorrido se repite si se acaba. profile.h marca en GPIOR0 el inicio de cada cuadro, el final de
+  cada etapa y el final de la medición, y host/simavr_bench.c cuenta los ciclos entre marcas. Como el
+  emulador es determinista, dos ejecuciones de la misma imagen dan exactamente los mismos ciclos.
+
+  Cambiar el recorrido cambia las cifras: compara solo mediciones hechas con la misma tabla.
+*/
+
+// Tramo del recorrido: botones (máscara de BUTTONS) y cuadros que se mantienen
+struct BenchStep {
+  uint8_t buttons;
+  uint8_t frames;
+};
+
+const static BenchStep bench_script[] PROGMEM = {
+  { 0,          4 },   // Cámara quieta en el inicio
+  { UP,        28 },   // Cruza la puerta hasta el pasillo
+  { RIGHT,     13 },   // Gira hacia el sur
+  { UP,        30 },   // Baja por el pasillo hasta la sala del enemigo
+  { LEFT,      10 },   // Encara al enemigo
+  { Y,          3 },   // Dispara
+  { 0,          6 },
+  { Y,          3 },
+  { 0,          6 },
+  { Y,          3 },
+  { DOWN,      12 },   // Retrocede
+  { LEFT,      26 },   // Giro sobre el sitio
+};
+
+#define BENCH_STEPS           (sizeof(bench_script) / sizeof(BenchStep))
+
+// Botones del cuadro frame del recorrido
+uint16_t getBenchInput(uint16_t frame) {
+  uint16_t total = 0;
+  for (uint8_t i = 0; i < BENCH_STEPS; i++) total += pgm_read_byte(&bench_script[i].frames);
+
+  frame %= total;
+  for (uint8_t i = 0; i < BENCH_STEPS; i++) {
+    uint8_t frames = pgm_read_byte(&bench_script[i].frames);
+    if (frame < frames) return pgm_read_byte(&bench_script[i].buttons);
+    frame -= frames;
+  }
+  return 0;
+}
+
+#endif
@@ -48,6 +48,11 @@ constexpr uint8_t SOUND_PIN   = 9;
 // Tiempo deseado por cuadro en ms (~15 FPS)
 #define FRAME_TIME          66.666666  
 
+// La lógica avanza a pasos fijos de FRAME_TIME: si un cuadro tarda más, se simulan varios pasos seguidos
+// antes de dibujar, hasta MAX_TICKS_PER_FRAME (con más retraso el juego se ralentiza en lugar de saltar)
+#define TICK_TIME_US        ((uint32_t) (FRAME_TIME * 1000)) // Duración de un paso de simulación en us
+#define MAX_TICKS_PER_FRAME 4           // Pasos simulados como máximo por cuadro dibujado
+
 // Configuración de resolución
 #define RES_DIVIDER         2           // Divide la resolución horizontal; valores más altos reducen el uso de memoria y proceso
 #define Z_RES_DIVIDER       2           // Divide la resolución del Z-buffer; sacrifica resolución para ahorrar memoria
@@ -56,6 +61,37 @@ constexpr uint8_t SOUND_PIN   = 9;
 #define DISTANCE_MULTIPLIER 20          // Multiplicador para aumentar la precisión de las distancias en uint8_t
 #define MAX_RENDER_DEPTH    12          // Profundidad máxima para el raycasting
 #define MAX_SPRITE_DEPTH    8           // Profundidad máxima para sprites renderizados
+#define VIEW_DEPTH_SHIFT    10          // Bits fraccionarios de la profundidad en la caché de vista (hasta 64 celdas)
+#define VIEW_SCALE_SHIFT    12          // Bits fraccionarios de la escala en la caché de vista (hasta 16, profundidad > 0.1)
+
+// Paredes con textura en lugar del gradiente plano; descomenta la línea para activar las texturas
+// #define TEXTURED_WALLS
+
+// Suelo y techo sombreados con el gradiente en lugar de negro
+// #define FLOOR_CEILING
+#define FLOOR_INTENSITY     2           // Intensidad del suelo junto al jugador (de 0 a GRADIENT_COUNT - 1)
+#define CEILING_INTENSITY   1           // Intensidad del techo junto al jugador
+
+// Nivel de detalle por columnas: las paredes lejanas fuera del centro se muestrean con menos rayos
+// #define COLUMN_LOD
+#define LOD_DISTANCE        4           // Distancia (en celdas) a partir de la que se agrupan columnas
+#define LOD_SPAN            4           // Columnas de RES_DIVIDER píxeles que cubre cada rayo lejano
+#define LOD_CENTER_WIDTH    32          // Ancho (en píxeles) del centro de la pantalla siempre a resolución completa
+#define LOD_MAX_DELTA       1           // Diferencia de distancia (en celdas) a partir de la que se refina un tramo
+
+// Reutiliza las columnas del cuadro anterior si la cámara no se ha movido (3 o 4 bytes de RAM por columna)
+// #define COLUMN_CACHE
+
+// Cruza de un paso los rectángulos vacíos de la tabla de distancias de level.h (tools/level_tables.py):
+// en sto_level_1, 2,78 pasos del DDA por rayo en lugar de 4,65 (-40%), pero 4,04 lecturas de PROGMEM
+// en lugar de 4,65 (-13%), que son el coste en AVR; ocupa LEVEL_SIZE bytes más de flash
+// #define EMPTY_SPACE_SKIP
+
+// Transiciones entre escenas
+#define TRANSITION_FADE     0           // Desvanecimiento con el gradiente de tramado
+#define TRANSITION_WIPE     1           // Barrido de izquierda a derecha con borde degradado
+#define TRANSITION_DISSOLVE 2           // Disolución con el gradiente desordenado por columnas
+#define SCENE_TRANSITION    TRANSITION_FADE // Transición usada al cambiar de escena
 
 // Tamaño del Z-buffer
 #define ZBUFFER_SIZE        SCREEN_WIDTH / Z_RES_DIVIDER
@@ -70,11 +106,52 @@ constexpr uint8_t SOUND_PIN   = 9;
 #define LEVEL_HEIGHT        57                      // Altura del nivel en píxeles
 #define LEVEL_SIZE          LEVEL_WIDTH / 2 * LEVEL_HEIGHT // Tamaño del nivel comprimido
 
+// Paredes en un mapa de 1 bit por celda que initializeLevel() construye en RAM (WALL_BITMAP_SIZE bytes);
+// el raycaster, las colisiones y la línea de visión lo consultan antes de leer el nivel, y con el mapa de objetos
+// que level_compiler.h genera en flash (otros WALL_BITMAP_SIZE bytes) solo leen el nivel en puertas y entidades
+// #define WALL_BITMAP
+
+// Con WALL_BITMAP, usa en flash el mapa de bits que level_compiler.h genera para el nivel en lugar de copiarlo a RAM
+// #define WALL_BITMAP_PROGMEM
+
+#define WALL_ROW_BYTES      (LEVEL_WIDTH / 8)                // Bytes por fila del mapa de paredes
+#define WALL_BITMAP_SIZE    (WALL_ROW_BYTES * LEVEL_HEIGHT)  // Tamaño del mapa de paredes
+
 // ------------------------------------
 // Escenas
 // ------------------------------------
 #define INTRO                 0       // Escena de introducción
 #define GAME_PLAY             1       // Escena principal del juego
+#define RENDER_CHECK          2       // Escena de verificación del renderizado
+#define BENCH                 3       // Escena de medición en el emulador simavr
+
+// ------------------------------------
+// Verificación del renderizado
+// ------------------------------------
+
+// Descomenta la siguiente línea para arrancar en la escena de verificación: renderiza poses fijas
+// de sto_level_1 y compara el hash del búfer con los valores de referencia de render_check.h
+// #define RUN_RENDER_CHECK
+
+// Descomenta la siguiente línea para imprimir por Serial nuevos valores de referencia en lugar de compararlos
+// #define RENDER_CHECK_RECORD
+
+#define RENDER_CHECK_TOLERANCE 0      // Píxeles distintos aceptados por host/render_check frente a la imagen de referencia (0 = exacto)
+
+// Descomenta la siguiente línea para imprimir por Serial el tiempo medio (us) de cada etapa del cuadro
+// #define PROFILE_STAGES
+
+#define PROFILE_FRAMES      32          // Cuadros promediados en cada informe
+
+// Descomenta la siguiente línea (o pasa -DBENCH_SIMAVR al compilar) para arrancar en la escena de
+// medición: juega el recorrido de bench.h y marca las etapas en GPIOR0 para host/simavr_bench.c
+// #define BENCH_SIMAVR
+
+#define BENCH_FRAMES        144         // Cuadros medidos por la escena BENCH (una vuelta al recorrido de bench.h)
+
+// Compilación para el ordenador: HOST_BUILD lo define la línea de órdenes de g++, nunca el sketch.
+// renderMapThreaded() reparte entonces las columnas entre RENDER_THREADS hilos
+#define RENDER_THREADS      0           // Hilos del renderizado en HOST_BUILD, incluido el principal (0: uno por núcleo)
 
 // ------------------------------------
 // Configuración del juego
@@ -91,12 +168,29 @@ constexpr uint8_t SOUND_PIN   = 9;
 
 #define JOGGING_SPEED         .005    // Velocidad de oscilación al caminar
 #define ENEMY_SPEED           .02     // Velocidad de movimiento de enemigos
+#define FLOW_LAYERS_PER_FRAME 4       // Capas del campo de flujo calculadas por cuadro
+#define SIGHT_CHECKS_PER_FRAME 2      // Enemigos cuya línea de visión se comprueba en cada cuadro
+
+// Planificación de la IA: los enemigos lejanos y fuera de la vista se actualizan cada AI_FAR_INTERVAL
+// pasos, en su turno según el UID, aplicando de golpe los pasos acumulados, mientras el tiempo de
+// updateEntities() en el paso no supere AI_BUDGET_US; los que no caben conservan sus pasos pendientes
+// para el siguiente. Con AI_FAR_MAX_OWED pasos pendientes se actualizan aunque no quede presupuesto
+#define AI_NEAR_DIST          60      // Distancia por debajo de la que un enemigo se actualiza siempre (* DISTANCE_MULTIPLIER)
+#define AI_FAR_INTERVAL       4       // Pasos entre actualizaciones de un enemigo lejano
+#define AI_BUDGET_US          3000    // Presupuesto por paso para los enemigos lejanos (microsegundos)
+#define AI_FAR_MAX_OWED       (2 * AI_FAR_INTERVAL) // Pasos pendientes a partir de los que se ignora el presupuesto
 #define FIREBALL_SPEED        .2      // Velocidad de proyectiles
 #define FIREBALL_ANGLES       45      // Número de ángulos por PI para proyectiles
+#define DOOR_SPEED            32      // Avance de la apertura de puertas por cuadro (de 0 a 255)
 
 // Límite de entidades activas
 #define MAX_ENTITIES          10      // Número máximo de entidades activas
-#define MAX_STATIC_ENTITIES   28      // Número máximo de entidades estáticas
+#define MAX_STATIC_ENTITIES   28      // Número máximo de entidades estáticas (incluye las puertas)
+#define DOOR_TABLE_SIZE       32      // Tamaño de la tabla de puertas por celda (potencia de 2 > MAX_STATIC_ENTITIES)
+
+// Campo de flujo de los enemigos: ventana de celdas centrada en el jugador
+#define FLOW_SIZE             16      // Lado de la ventana (par); ocupa FLOW_SIZE * FLOW_SIZE / 2 bytes
+#define FLOW_UNREACHED        15      // Distancia de las celdas no alcanzadas (máximo de 4 bits)
 
 // Distancias máximas y rangos de colisión
 #define MAX_ENTITY_DISTANCE   200     // Distancia máxima para entidades activas (* DISTANCE_MULTIPLIER)
@@ -106,6 +200,9 @@ constexpr uint8_t SOUND_PIN   = 9;
 #define FIREBALL_COLLIDER_DIST 2      // Distancia de colisión para proyectiles (* DISTANCE_MULTIPLIER)
 #define ENEMY_MELEE_DIST      6       // Distancia para ataques cuerpo a cuerpo (* DISTANCE_MULTIPLIER)
 #define WALL_COLLIDER_DIST    .2      // Distancia de colisión con paredes
+#define DOOR_OPEN_CELLS       1       // Celdas alrededor de una puerta que la abren al acercarse
+#define DOOR_CLOSE_CELLS      2       // Celdas de distancia a partir de las que una puerta se cierra
+#define DOOR_PASSABLE_OFFSET  192     // Apertura mínima para atravesar una puerta (de 0 a 255)
 
 // Daños
 #define ENEMY_MELEE_DAMAGE    8       // Daño de enemigos en cuerpo a cuerpo
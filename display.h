@@ -6,6 +6,7 @@
 
 #include "SSD1306.h"
 #include "constants.h"
+#include "render_config.h"
 
 // Macro para leer un carácter de una cadena en memoria Flash
 #define F_char(ifsh, ch)    pgm_read_byte(reinterpret_cast<PGM_P>(ifsh) + ch)
@@ -14,33 +15,80 @@
 const static uint8_t PROGMEM bit_mask[8] = { 128, 64, 32, 16, 8, 4, 2, 1 };
 #define read_bit(b, n)      b & pgm_read_byte(bit_mask + n) ? 1 : 0
 
+// Tramos de las columnas de los sprites (formato de tools/sprite_tables.py): tipo << 6 | longitud
+#define SPAN_TRANSPARENT    0                  // 0x00 termina la columna
+#define SPAN_BLACK          1
+#define SPAN_WHITE          2
+#define SPAN_BITS           3                  // Seguido de (longitud + 7) / 8 bytes de colores
+#define SPAN_LENGTH_MASK    0x3F
+
 // Declaración de funciones
 void setupDisplay();
-void fps();
+void startTicks();
+uint8_t fps();
 bool getGradientPixel(uint8_t x, uint8_t y, uint8_t i);
 void fadeScreen(uint8_t intensity, bool color);
+void transitionScreen(uint8_t style, uint8_t step, bool color);
 void drawByte(uint8_t x, uint8_t y, uint8_t b);
 uint8_t getByte(uint8_t x, uint8_t y);
-void drawPixel(int8_t x, int8_t y, bool color, bool raycasterViewport);
-void drawVLine(uint8_t x, int8_t start_y, int8_t end_y, uint8_t intensity);
-void drawSprite(int8_t x, int8_t y, const uint8_t bitmap[], const uint8_t mask[], int16_t w, int16_t h, uint8_t sprite, double distance);
-void drawChar(int8_t x, int8_t y, char ch);
-void drawText(int8_t x, int8_t y, char *txt, uint8_t space = 1);
-void drawText(int8_t x, int8_t y, const __FlashStringHelper *txt, uint8_t space = 1);
+template <class Config = RenderDefault> void drawPixel(typename Config::coord x, typename Config::coord y, bool color, bool raycasterViewport = false);
+template <class Config = RenderDefault> void drawVLine(typename Config::pixel x, typename Config::coord start_y, typename Config::coord end_y, uint8_t intensity);
+template <class Config = RenderDefault> uint8_t getFloorCeilingByte(typename Config::pixel x, typename Config::pixel y, typename Config::coord lower_y, typename Config::coord higher_y);
+#ifdef FLOOR_CEILING
+template <class Config = RenderDefault> void drawFloorCeiling(typename Config::pixel x, typename Config::coord start_y, typename Config::coord end_y);
+#endif
+#ifdef TEXTURED_WALLS
+template <class Config = RenderDefault> void drawTexturedVLine(typename Config::pixel x, typename Config::coord start_y, typename Config::coord end_y, const uint8_t texture[], uint8_t tex_x, uint8_t intensity);
+#endif
+template <class Config> struct ScreenSprite;
+template <class Config = RenderDefault> bool placeSprite(ScreenSprite<Config> *s, typename Config::coord x, typename Config::coord y, const uint8_t spans[], const uint16_t frames[], uint8_t w, uint8_t h, uint8_t sprite, uint16_t depth);
+template <class Config = RenderDefault> void drawSprites(ScreenSprite<Config> sprites[], uint8_t count);
+template <class Config = RenderDefault> void drawOverlay(typename Config::coord x, typename Config::coord y, const uint8_t bitmap[], const uint8_t mask[], uint8_t w, uint8_t h, typename Config::pixel clip_y);
+template <class Config = RenderDefault> void clearRect(typename Config::pixel x, typename Config::pixel y, typename Config::pixel w, typename Config::pixel h);
+template <class Config = RenderDefault> void drawGlyph(typename Config::coord x, typename Config::coord y, uint8_t c);
+template <class Config = RenderDefault> void drawChar(typename Config::coord x, typename Config::coord y, char ch);
+template <class Config = RenderDefault> void drawText(typename Config::coord x, typename Config::coord y, char *txt, uint8_t space = 1);
+template <class Config = RenderDefault> void drawText(typename Config::coord x, typename Config::coord y, const __FlashStringHelper *txt, uint8_t space = 1);
+template <class Config = RenderDefault> void drawText(typename Config::pixel x, typename Config::pixel y, uint8_t num);
+#ifdef RUN_RENDER_CHECK
+uint32_t getFrameHash();
+void dumpFrame();
+#endif
 
 // Inicialización de la pantalla OLED
 Adafruit_SSD1306<SCREEN_WIDTH, SCREEN_HEIGHT> display;
 
-// Control de FPS (fotogramas por segundo)
-double delta = 1;              // Variación de tiempo entre fotogramas
-uint32_t lastFrameTime = 0;    // Tiempo del último fotograma
+// Control de FPS (fotogramas por segundo) y del paso fijo de la simulación
+double delta = 1;              // Duración del último fotograma en unidades de FRAME_TIME (para mostrar los FPS)
+uint32_t lastFrameTime = 0;    // Tiempo del último fotograma (us)
+uint32_t tick_time = 0;        // Tiempo real pendiente de simular (us)
 
-#ifdef OPTIMIZE_SSD1306
 uint8_t *display_buf;          // Buffer directo para optimización de SSD1306
-#endif
 
 uint8_t zbuffer[ZBUFFER_SIZE]; // Buffer de profundidad para raycasting
 
+// Búferes de imagen y de profundidad de una geometría de render_config.h. La pantalla usa
+// display_buf y zbuffer; las demás geometrías (solo en el host) reservan los suyos al instanciarse.
+template <class Geometry, bool OnScreen = Geometry::on_screen>
+struct FrameTarget {
+    static uint8_t frame[Geometry::width * Geometry::pages];
+    static uint8_t depth[Geometry::width];
+
+    static uint8_t *getFrame() { return frame; }
+    static uint8_t *getDepth() { return depth; }
+};
+
+template <class Geometry, bool OnScreen>
+uint8_t FrameTarget<Geometry, OnScreen>::frame[Geometry::width * Geometry::pages];
+template <class Geometry, bool OnScreen>
+uint8_t FrameTarget<Geometry, OnScreen>::depth[Geometry::width];
+
+template <class Geometry>
+struct FrameTarget<Geometry, true> {
+    static uint8_t *getFrame() { return display_buf; }
+    static uint8_t *getDepth() { return zbuffer; }
+};
+
 // ------------------------------------
 // Configuración de la pantalla
 // ------------------------------------
@@ -50,18 +98,37 @@ void setupDisplay() {
         while (1); // Detiene la ejecución si falla la inicialización
     }
 
-#ifdef OPTIMIZE_SSD1306
     display_buf = display.getBuffer();
-#endif
 
     memset(zbuffer, 0xFF, ZBUFFER_SIZE); // Inicializa el z-buffer
 }
 
-// Control de FPS: limita la velocidad de actualización y calcula delta
-void fps() {
-    while (millis() - lastFrameTime < FRAME_TIME); // Espera el tiempo necesario
-    delta = (double)(millis() - lastFrameTime) / FRAME_TIME; // Calcula delta
-    lastFrameTime = millis();
+// Empieza a contar el tiempo de simulación desde ahora (al entrar en la escena de juego)
+void startTicks() {
+    lastFrameTime = micros();
+    tick_time = 0;
+}
+
+// Control de FPS: espera a que haya al menos un paso de simulación pendiente y devuelve cuántos
+// pasos de TICK_TIME_US hay que simular antes de dibujar el cuadro
+uint8_t fps() {
+    uint32_t now;
+    do {
+        now = micros();
+    } while (tick_time + (now - lastFrameTime) < TICK_TIME_US); // Espera el tiempo necesario
+
+    delta = (double)(now - lastFrameTime) / TICK_TIME_US; // Calcula delta
+    tick_time += now - lastFrameTime;
+    lastFrameTime = now;
+
+    uint32_t ticks = tick_time / TICK_TIME_US;
+    if (ticks > MAX_TICKS_PER_FRAME) {
+        tick_time = 0; // Descarta el retraso que no se puede recuperar
+        return MAX_TICKS_PER_FRAME;
+    }
+
+    tick_time -= ticks * TICK_TIME_US;
+    return ticks;
 }
 
 // Devuelve los FPS actuales
@@ -75,9 +142,7 @@ double getActualFps() {
 
 // Dibuja un byte verticalmente en el buffer de pantalla
 void drawByte(uint8_t x, uint8_t y, uint8_t b) {
-#ifdef OPTIMIZE_SSD1306
     display_buf[(y / 8) * SCREEN_WIDTH + x] = b;
-#endif
 }
 
 // Obtiene un píxel de un gradiente predefinido
@@ -93,136 +158,534 @@ boolean getGradientPixel(uint8_t x, uint8_t y, uint8_t i) {
 
 // Efecto de desvanecimiento de pantalla
 void fadeScreen(uint8_t intensity, bool color = 0) {
+#ifdef OPTIMIZE_SSD1306
+    // Copia el patrón de la intensidad a RAM y lo aplica con una operación por byte del búfer
+    uint8_t pattern[GRADIENT_PAGE_WIDTH];
+    memcpy_P(pattern, gradient_page + min(intensity, GRADIENT_COUNT - 1) * GRADIENT_PAGE_WIDTH, GRADIENT_PAGE_WIDTH);
+
+    uint8_t *buf = display_buf;
+    for (uint8_t page = 0; page < SCREEN_HEIGHT / 8; page++) {
+        for (uint8_t x = 0; x < SCREEN_WIDTH; x++, buf++) {
+            if (color) *buf |= pattern[x % GRADIENT_PAGE_WIDTH];
+            else *buf &= ~pattern[x % GRADIENT_PAGE_WIDTH];
+        }
+    }
+#else
     for (uint8_t x = 0; x < SCREEN_WIDTH; x++) {
         for (uint8_t y = 0; y < SCREEN_HEIGHT; y++) {
             if (getGradientPixel(x, y, intensity))
                 drawPixel(x, y, color, false);
         }
     }
+#endif
 }
 
-// Dibujado optimizado de píxeles
-void drawPixel(int8_t x, int8_t y, bool color, bool raycasterViewport = false) {
-    if (x < 0 || x >= SCREEN_WIDTH || y < 0 || y >= (raycasterViewport ? RENDER_HEIGHT : SCREEN_HEIGHT)) return;
+// Transición de pantalla por pasos (0 a GRADIENT_COUNT - 1) usando los patrones de gradient_page
+void transitionScreen(uint8_t style, uint8_t step, bool color = 0) {
+    if (style == TRANSITION_FADE) {
+        fadeScreen(step, color);
+        return;
+    }
+
+    // El barrido avanza un borde de 16 columnas que recorre todos los niveles del gradiente
+    int16_t edge = (step + 1) * (SCREEN_WIDTH + 2 * GRADIENT_COUNT) / GRADIENT_COUNT;
+
+    for (uint8_t page = 0; page < SCREEN_HEIGHT / 8; page++) {
+        for (uint8_t x = 0; x < SCREEN_WIDTH; x++) {
+            uint8_t b;
+
+            if (style == TRANSITION_WIPE) {
+                int16_t intensity = (edge - x) / 2;
+                b = intensity <= 0 ? 0 : pgm_read_byte(
+                    gradient_page + min(intensity, GRADIENT_COUNT - 1) * GRADIENT_PAGE_WIDTH + x % GRADIENT_PAGE_WIDTH
+                );
+            } else {
+                // Disolución: la misma columna y rotación en todos los pasos conserva el orden del tramado
+                uint8_t rotation = (x / GRADIENT_PAGE_WIDTH + page * 3) & 7;
+                b = pgm_read_byte(gradient_page + step * GRADIENT_PAGE_WIDTH + (x * 7 + page * 5) % GRADIENT_PAGE_WIDTH);
+                b = b << rotation | b >> (8 - rotation);
+            }
 
 #ifdef OPTIMIZE_SSD1306
-    if (color) {
-        display_buf[x + (y / 8) * SCREEN_WIDTH] |= (1 << (y & 7));
-    } else {
-        display_buf[x + (y / 8) * SCREEN_WIDTH] &= ~(1 << (y & 7));
-    }
+            if (color) display_buf[page * SCREEN_WIDTH + x] |= b;
+            else display_buf[page * SCREEN_WIDTH + x] &= ~b;
 #else
-    display.drawPixel(x, y, color);
+            for (uint8_t bit = 0; bit < 8; bit++) {
+                if (b & (1 << bit)) drawPixel(x, page * 8 + bit, color, false);
+            }
 #endif
+        }
+    }
+}
+
+// Dibujado optimizado de píxeles
+template <class Config>
+void drawPixel(typename Config::coord x, typename Config::coord y, bool color, bool raycasterViewport) {
+    if (x < 0 || x >= Config::width || y < 0 || y >= (raycasterViewport ? Config::render_height : Config::height)) return;
+
+    if (Config::page_writes) {
+        uint8_t *buf = FrameTarget<typename Config::geometry>::getFrame();
+        if (color) {
+            buf[x + (y / 8) * Config::width] |= (1 << (y & 7));
+        } else {
+            buf[x + (y / 8) * Config::width] &= ~(1 << (y & 7));
+        }
+    } else {
+        display.drawPixel(x, y, color);
+    }
 }
 
 // Dibuja una línea vertical con gradiente
-void drawVLine(uint8_t x, int8_t start_y, int8_t end_y, uint8_t intensity) {
-    int8_t lower_y = max(min(start_y, end_y), 0);
-    int8_t higher_y = min(max(start_y, end_y), RENDER_HEIGHT - 1);
+template <class Config>
+void drawVLine(typename Config::pixel x, typename Config::coord start_y, typename Config::coord end_y, uint8_t intensity) {
+    typedef typename Config::coord coord;
+    coord lower_y = max(min(start_y, end_y), 0);
+    coord higher_y = min(max(start_y, end_y), Config::render_height - 1);
+
+    if (Config::page_writes) {
+        uint8_t *buf = FrameTarget<typename Config::geometry>::getFrame();
+        uint8_t b = 0, bp;
+        for (uint8_t c = 0; c < Config::res_divider; c++) {
+            for (coord y = lower_y; y <= higher_y; y++) {
+                bp = y % 8;
+                b |= getGradientPixel(x + c, y, intensity) << bp;
+                if (bp == 7) {
+                    buf[(y / 8) * Config::width + x + c] = b | getFloorCeilingByte<Config>(x + c, y, lower_y, higher_y);
+                    b = 0;
+                }
+            }
+            if (bp != 7) buf[(higher_y / 8) * Config::width + x + c] = b | getFloorCeilingByte<Config>(x + c, higher_y, lower_y, higher_y);
+        }
+    } else {
+        for (coord y = lower_y; y <= higher_y; y++) {
+            for (uint8_t c = 0; c < Config::res_divider; c++) {
+                if (getGradientPixel(x + c, y, intensity)) drawPixel<Config>(x + c, y, 1, true);
+            }
+        }
+    }
+}
 
-#ifdef OPTIMIZE_SSD1306
-    uint8_t b = 0, bp;
-    for (uint8_t c = 0; c < RES_DIVIDER; c++) {
-        for (int8_t y = lower_y; y <= higher_y; y++) {
-            bp = y % 8;
-            b |= getGradientPixel(x + c, y, intensity) << bp;
-            if (bp == 7) {
-                drawByte(x + c, y, b);
+#ifdef TEXTURED_WALLS
+// Dibuja una columna de textura escalada entre start_y y end_y.
+// La columna (4 bytes) se lee una sola vez de PROGMEM y se recorre con un paso en punto fijo 8.8;
+// los píxeles se acumulan en bytes de página y se sombrean con el patrón de gradient_page.
+template <class Config>
+void drawTexturedVLine(typename Config::pixel x, typename Config::coord start_y, typename Config::coord end_y, const uint8_t texture[], uint8_t tex_x, uint8_t intensity) {
+    typedef typename Config::coord coord;
+    coord lower_y = max(start_y, 0);
+    coord higher_y = min(end_y, Config::render_height - 1);
+    if (lower_y > higher_y) return;
+
+    uint8_t column[BMP_TEXTURE_SIZE / 8];
+    memcpy_P(column, texture + tex_x * (BMP_TEXTURE_SIZE / 8), BMP_TEXTURE_SIZE / 8);
+
+    uint16_t step = (BMP_TEXTURE_SIZE << 8) / (end_y - start_y + 1);
+    uint16_t tex_y = (lower_y - start_y) * step;
+    const uint8_t *shade = gradient_page + min(intensity, GRADIENT_COUNT - 1) * GRADIENT_PAGE_WIDTH;
+
+    if (Config::page_writes) {
+        uint8_t b = 0;
+        for (coord y = lower_y; y <= higher_y; y++) {
+            uint8_t row = tex_y >> 8;
+            if (column[row >> 3] & (1 << (row & 7))) b |= 1 << (y & 7);
+            tex_y += step;
+
+            if ((y & 7) == 7 || y == higher_y) {
+                uint8_t *buf = FrameTarget<typename Config::geometry>::getFrame() + (y / 8) * Config::width + x;
+                for (uint8_t c = 0; c < Config::res_divider; c++) {
+                    buf[c] = (b & pgm_read_byte(shade + (x + c) % GRADIENT_PAGE_WIDTH))
+                             | getFloorCeilingByte<Config>(x + c, y, lower_y, higher_y);
+                }
                 b = 0;
             }
         }
-        if (bp != 7) drawByte(x + c, higher_y, b);
+    } else {
+        for (coord y = lower_y; y <= higher_y; y++) {
+            uint8_t row = tex_y >> 8;
+            tex_y += step;
+            if (!(column[row >> 3] & (1 << (row & 7)))) continue;
+
+            for (uint8_t c = 0; c < Config::res_divider; c++) {
+                if (pgm_read_byte(shade + (x + c) % GRADIENT_PAGE_WIDTH) & (1 << (y & 7))) drawPixel<Config>(x + c, y, 1, true);
+            }
+        }
     }
+}
+#endif
+
+// Bits de suelo y techo de la página de la fila y que quedan fuera de la pared [lower_y, higher_y],
+// para combinarlos con el byte de la pared en una sola escritura (0 sin FLOOR_CEILING)
+template <class Config>
+uint8_t getFloorCeilingByte(typename Config::pixel x, typename Config::pixel y, typename Config::coord lower_y, typename Config::coord higher_y) {
+#ifdef FLOOR_CEILING
+    static_assert(Config::render_height == RENDER_HEIGHT, "floor_ceiling_page tiene RENDER_HEIGHT / 8 páginas");
+
+    uint8_t page = y / 8;
+    typename Config::coord top = page * 8;
+    uint8_t mask = 0xFF;
+
+    if (lower_y > top) mask <<= lower_y - top;
+    if (higher_y < top + 7) mask &= 0xFF >> (top + 7 - higher_y);
+
+    return pgm_read_byte(floor_ceiling_page + page * GRADIENT_PAGE_WIDTH + x % GRADIENT_PAGE_WIDTH) & ~mask;
 #else
-    for (int8_t y = lower_y; y <= higher_y; y++) {
-        for (uint8_t c = 0; c < RES_DIVIDER; c++) {
-            if (getGradientPixel(x + c, y, intensity)) drawPixel(x + c, y, 1, true);
+    (void) x; (void) y; (void) lower_y; (void) higher_y; // Sin suelo ni techo no hay bits que añadir
+    return 0;
+#endif
+}
+
+#ifdef FLOOR_CEILING
+// Rellena con el suelo y el techo las páginas de la columna que no toca la pared entre start_y y end_y
+template <class Config>
+void drawFloorCeiling(typename Config::pixel x, typename Config::coord start_y, typename Config::coord end_y) {
+    static_assert(Config::render_height == RENDER_HEIGHT, "floor_ceiling_page tiene RENDER_HEIGHT / 8 páginas");
+    if (!Config::page_writes) return;
+
+    typename Config::coord lower_y = max(start_y, 0);
+    typename Config::coord higher_y = min(end_y, Config::render_height - 1);
+    uint8_t *buf = FrameTarget<typename Config::geometry>::getFrame();
+
+    for (uint8_t page = 0; page < RENDER_HEIGHT / 8; page++) {
+        if (page * 8 <= higher_y && page * 8 + 7 >= lower_y) continue;
+
+        const uint8_t *pattern = floor_ceiling_page + page * GRADIENT_PAGE_WIDTH;
+        for (uint8_t c = 0; c < Config::res_divider; c++) {
+            buf[page * Config::width + x + c] = pgm_read_byte(pattern + (x + c) % GRADIENT_PAGE_WIDTH);
         }
     }
-#endif
 }
+#endif
 
-// Renderiza un sprite con escala, máscara, y corrección de perspectiva
-void drawSprite(
-    int8_t x, int8_t y,
-    const uint8_t bitmap[], const uint8_t mask[],
-    int16_t w, int16_t h,
-    uint8_t sprite, double distance
+// Sprite escalado y colocado en pantalla por placeSprite(), pendiente de dibujar con drawSprites()
+// (10 bytes en la pantalla de 128x64)
+template <class Config>
+struct ScreenSprite {
+    const uint8_t *column;           // Tramos de la columna column_x del sprite
+    uint8_t column_x;
+    typename Config::coord x;        // Esquina superior izquierda en pantalla
+    typename Config::coord y;
+    typename Config::pixel tw;       // Tamaño en pantalla
+    typename Config::pixel th;
+    uint8_t pixel_size;              // Lado de los bloques de píxeles al ampliar
+    uint16_t depth;                  // Distancia con VIEW_DEPTH_SHIFT bits fraccionarios, como en EntityView
+};
+
+// Coloca un sprite de una hoja por columnas con escala y corrección de perspectiva. Devuelve false
+// si la pared de su columna izquierda está más cerca (control de profundidad basado en z-buffer) y
+// no hay que dibujarlo
+template <class Config>
+bool placeSprite(
+    ScreenSprite<Config> *s,
+    typename Config::coord x, typename Config::coord y,
+    const uint8_t spans[], const uint16_t frames[],
+    uint8_t w, uint8_t h,
+    uint8_t sprite, uint16_t depth
 ) {
-    // Control de profundidad basado en z-buffer
-    if (zbuffer[min(max(x, 0), ZBUFFER_SIZE - 1) / Z_RES_DIVIDER] < distance * DISTANCE_MULTIPLIER) {
-        return;
+    double distance = (double) depth / (1 << VIEW_DEPTH_SHIFT);
+    uint8_t *zdepth = FrameTarget<typename Config::geometry>::getDepth();
+    if (zdepth[min(max(x, 0), Config::width / Config::z_res_divider - 1) / Config::z_res_divider] < distance * Config::distance_multiplier) {
+        return false;
+    }
+
+    s->column = spans + pgm_read_word(frames + sprite);
+    s->column_x = 0;
+    s->x = x;
+    s->y = y;
+    s->tw = w / distance;
+    s->th = h / distance;
+    s->pixel_size = max(1, 1.0 / distance);
+    s->depth = depth;
+    return true;
+}
+
+// Avanza los tramos del sprite hasta la columna sx (las columnas solo se recorren hacia la derecha)
+template <class Config>
+void seekSpriteColumn(ScreenSprite<Config> *s, uint8_t sx) {
+    for (; s->column_x < sx; s->column_x++) {
+        uint8_t tag;
+        while ((tag = pgm_read_byte(s->column++)) != 0) {
+            if (tag >> 6 == SPAN_BITS) s->column += ((tag & SPAN_LENGTH_MASK) + 7) / 8;
+        }
+    }
+}
+
+// Indica si las filas [from, to) de una columna están cubiertas (un bit por fila, por páginas)
+template <class Config>
+bool isSpanCovered(const uint8_t cover[], typename Config::pixel from, typename Config::pixel to) {
+    while (from < to) {
+        typename Config::pixel page = from >> 3;
+        typename Config::pixel end = min(to, (page + 1) * 8);
+        uint8_t bits = (0xFF << (from & 7)) & (0xFF >> ((page + 1) * 8 - end));
+        if ((cover[page] & bits) != bits) return false;
+        from = end;
     }
+    return true;
+}
 
-    uint8_t tw = w / distance;
-    uint8_t th = h / distance;
-    uint8_t pixel_size = max(1, 1.0 / distance);
+// Dibuja los sprites de delante hacia atrás (sprites[0] es el más cercano), columna a columna de la
+// pantalla. La cobertura de la columna guarda por páginas los píxeles ya pintados por sprites más
+// cercanos: cada sprite solo pinta los que quedan libres, con el mismo resultado que pintarlos de
+// atrás hacia delante, y no lee los tramos de las columnas y bloques que ya están cubiertos. Así el
+// coste de una sala llena depende del área visible y no del número de sprites superpuestos.
+// Cada columna solo recorre los sprites que la cruzan (active, en orden de profundidad), que entran
+// por orden de x y salen al pasar su borde derecho; las columnas sin sprites se saltan.
+template <class Config>
+void drawSprites(ScreenSprite<Config> sprites[], uint8_t count) {
+    static_assert(MAX_ENTITIES <= 16, "drawSprites() guarda los sprites de la columna en 16 bits");
+    uint8_t cover[(Config::render_height + 7) / 8];
+    uint8_t order[MAX_ENTITIES]; // Índices de los sprites por x creciente
+
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t j = i;
+        for (; j > 0 && sprites[order[j - 1]].x > sprites[i].x; j--) order[j] = order[j - 1];
+        order[j] = i;
+    }
 
-    for (uint8_t ty = 0; ty < th; ty += pixel_size) {
-        if (y + ty < 0 || y + ty >= RENDER_HEIGHT) continue;
+    uint16_t active = 0; // Bit i: sprites[i] cruza la columna
+    uint8_t next = 0;    // Siguiente sprite de order que entra
 
-        for (uint8_t tx = 0; tx < tw; tx += pixel_size) {
-            if (x + tx < 0 || x + tx >= SCREEN_WIDTH) continue;
+    for (int16_t x = 0; x < Config::width; x++) {
+        if (!active) {
+            if (next == count) break;
+            x = max(x, sprites[order[next]].x);
+            if (x >= Config::width) break;
+        }
+        while (next < count && sprites[order[next]].x <= x) active |= 1U << order[next++];
 
-            uint8_t sx = tx * distance;
-            uint8_t sy = ty * distance;
-            uint8_t byte_offset = sprite * (w / 8) * h + sy * (w / 8) + sx / 8;
+        memset(cover, 0, sizeof(cover));
 
-            if (read_bit(pgm_read_byte(mask + byte_offset), sx % 8)) {
-                bool pixel = read_bit(pgm_read_byte(bitmap + byte_offset), sx % 8);
-                for (uint8_t ox = 0; ox < pixel_size; ox++) {
-                    for (uint8_t oy = 0; oy < pixel_size; oy++) {
-                        drawPixel(x + tx + ox, y + ty + oy, pixel, true);
+        uint16_t bits = active;
+        for (uint8_t i = 0; bits; i++, bits >>= 1) {
+            if (!(bits & 1)) continue;
+
+            ScreenSprite<Config> *s = &sprites[i];
+            if (x >= s->x + s->tw + s->pixel_size - 1) {
+                active &= ~(1U << i); // Pasado el borde derecho
+                continue;
+            }
+
+            // Bloque de la columna; los bloques que empiezan fuera de la pantalla no se dibujan
+            int16_t tx = x - s->x;
+            if (s->pixel_size > 1) tx = tx / s->pixel_size * s->pixel_size;
+            if (tx >= s->tw || s->x + tx < 0) continue;
+
+            int16_t top = max(s->y, 0);
+            int16_t bottom = min(s->y + s->th + s->pixel_size - 1, Config::render_height);
+            if (top >= bottom || isSpanCovered<Config>(cover, top, bottom)) continue; // Columna tapada
+
+            uint8_t sx = (uint32_t) tx * s->depth >> VIEW_DEPTH_SHIFT;
+            seekSpriteColumn(s, sx);
+
+            // Solo se recorren los tramos opacos: para cada uno se avanza al primer bloque de la
+            // pantalla cuya fila muestreada (ty * depth, como al escalar) cae dentro del tramo. Los
+            // tramos van de arriba abajo, así que ty solo avanza
+            const uint8_t *span = s->column;
+            int16_t ty = 0;
+            uint8_t row = 0;
+            uint8_t tag;
+            while ((tag = pgm_read_byte(span++)) != 0) {
+                uint8_t length = tag & SPAN_LENGTH_MASK;
+                uint8_t kind = tag >> 6;
+                const uint8_t *pixels = span;
+                if (kind == SPAN_BITS) span += (length + 7) / 8;
+                if (kind == SPAN_TRANSPARENT) {
+                    row += length;
+                    continue;
+                }
+
+                while ((uint32_t) ty * s->depth < (uint32_t) row << VIEW_DEPTH_SHIFT) ty += s->pixel_size;
+
+                for (; ty < s->th; ty += s->pixel_size) {
+                    uint8_t sy = (uint32_t) ty * s->depth >> VIEW_DEPTH_SHIFT;
+                    if (sy >= row + length) break;
+
+                    int16_t py = s->y + ty;
+                    if (py < 0) continue;
+                    if (py >= Config::render_height) break;
+
+                    int16_t block_end = min(py + s->pixel_size, Config::render_height);
+                    if (isSpanCovered<Config>(cover, py, block_end)) continue;
+
+                    bool pixel = kind == SPAN_WHITE || (kind == SPAN_BITS && read_bit(pgm_read_byte(pixels + (sy - row) / 8), (sy - row) % 8));
+                    for (int16_t oy = py; oy < block_end; oy++) {
+                        uint8_t bit = 1 << (oy & 7);
+                        if (cover[oy >> 3] & bit) continue;
+                        cover[oy >> 3] |= bit;
+                        drawPixel<Config>(x, oy, pixel, true);
                     }
                 }
+                row += length;
             }
         }
     }
 }
 
-// Renderiza un carácter individual en pantalla
-void drawChar(int8_t x, int8_t y, char ch) {
-    uint8_t c = 0;
-    while (CHAR_MAP[c] != ch && CHAR_MAP[c] != '\0') c++;
-    uint8_t bOffset = c / 2;
+// Dibuja un bitmap por columnas en formato de página (arma, fogonazo) sobre el búfer.
+// La máscara y la tinta se aplican en una sola pasada, desplazando cada byte entre dos páginas,
+// y las filas desde clip_y en adelante no se modifican. Sin máscara los píxeles solo se encienden.
+template <class Config>
+void drawOverlay(typename Config::coord x, typename Config::coord y, const uint8_t bitmap[], const uint8_t mask[], uint8_t w, uint8_t h, typename Config::pixel clip_y) {
+    typedef typename Config::coord coord;
+    uint8_t pages = (h + 7) / 8;
+    coord first_page = y >> 3;
+    uint8_t shift = y & 7;
+
+    for (uint8_t c = 0; c < w; c++) {
+        if (x + c < 0 || x + c >= Config::width) continue;
+
+        for (uint8_t p = 0; p < pages; p++) {
+            uint16_t ink = (uint16_t) pgm_read_byte(bitmap + c * pages + p) << shift;
+            uint16_t cut = mask ? (uint16_t) pgm_read_byte(mask + c * pages + p) << shift : 0;
+
+            // Escribe la parte baja en la página de destino y el resto en la siguiente
+            for (coord page = first_page + p; page <= first_page + p + 1; page++, ink >>= 8, cut >>= 8) {
+                if (page < 0 || page * 8 >= clip_y) continue;
+                uint8_t clip = clip_y - page * 8 >= 8 ? 0xFF : (1 << (clip_y - page * 8)) - 1;
+
+                if (Config::page_writes) {
+                    uint8_t *b = FrameTarget<typename Config::geometry>::getFrame() + page * Config::width + x + c;
+                    *b = (*b & ~(cut & clip)) | (ink & clip);
+                } else {
+                    for (uint8_t bit = 0; bit < 8; bit++) {
+                        if (!(clip & (1 << bit))) break;
+                        if (ink & (1 << bit)) drawPixel<Config>(x + c, page * 8 + bit, 1, false);
+                        else if (cut & (1 << bit)) drawPixel<Config>(x + c, page * 8 + bit, 0, false);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Borra un rectángulo de la imagen (zonas del HUD) con máscaras de página o con la biblioteca
+template <class Config>
+void clearRect(typename Config::pixel x, typename Config::pixel y, typename Config::pixel w, typename Config::pixel h) {
+    if (!Config::page_writes) {
+        display.clearRect(x, y, w, h);
+        return;
+    }
+
+    uint8_t *buf = FrameTarget<typename Config::geometry>::getFrame();
+    for (uint16_t top = y / 8 * 8; top < y + h; top += 8) {
+        uint8_t bits = 0xFF;
+        if (top < y) bits &= 0xFF << (y - top);
+        if (top + 8 > y + h) bits &= 0xFF >> (top + 8 - (y + h));
+        for (typename Config::pixel c = 0; c < w; c++) buf[top / 8 * Config::width + x + c] &= ~bits;
+    }
+}
+
+// Renderiza un glifo de la fuente (índice de CHAR_MAP) en pantalla
+template <class Config>
+void drawGlyph(typename Config::coord x, typename Config::coord y, uint8_t c) {
+    typedef typename Config::coord coord;
+    const uint8_t *glyph = bmp_font + c * CHAR_WIDTH;
 
-    for (uint8_t line = 0; line < CHAR_HEIGHT; line++) {
-        uint8_t b = pgm_read_byte(bmp_font + (line * bmp_font_width + bOffset));
+    if (Config::page_writes) {
+        // Cada columna del glifo se escribe con una o dos operaciones OR sobre las páginas afectadas
+        uint8_t *buf = FrameTarget<typename Config::geometry>::getFrame();
+        coord page = y >> 3;
+        uint8_t shift = y & 7;
+
+        for (uint8_t n = 0; n < CHAR_WIDTH; n++) {
+            if (x + n < 0 || x + n >= Config::width) continue;
+
+            uint16_t column = (uint16_t) pgm_read_byte(glyph + n) << shift;
+            if (page >= 0 && page < Config::geometry::pages) buf[page * Config::width + x + n] |= column;
+            if (page + 1 >= 0 && page + 1 < Config::geometry::pages) buf[(page + 1) * Config::width + x + n] |= column >> 8;
+        }
+    } else {
         for (uint8_t n = 0; n < CHAR_WIDTH; n++) {
-            if (read_bit(b, (c % 2 == 0 ? 0 : 4) + n)) drawPixel(x + n, y + line, 1, false);
+            uint8_t column = pgm_read_byte(glyph + n);
+            for (uint8_t line = 0; line < CHAR_HEIGHT; line++) {
+                if (column & (1 << line)) drawPixel<Config>(x + n, y + line, 1, false);
+            }
         }
     }
 }
 
+// Renderiza un carácter individual en pantalla
+template <class Config>
+void drawChar(typename Config::coord x, typename Config::coord y, char ch) {
+    uint8_t i = ch - CHAR_FIRST;
+    drawGlyph<Config>(x, y, i < CHAR_COUNT ? pgm_read_byte(char_index + i) : 0);
+}
+
 // Renderiza una cadena de texto en pantalla
-void drawText(int8_t x, int8_t y, char *txt, uint8_t space) {
-    uint8_t pos = x;
+template <class Config>
+void drawText(typename Config::coord x, typename Config::coord y, char *txt, uint8_t space) {
+    typename Config::pixel pos = x;
     uint8_t i = 0;
     char ch;
     while ((ch = txt[i]) != '\0') {
-        drawChar(pos, y, ch);
+        drawChar<Config>(pos, y, ch);
         i++;
         pos += CHAR_WIDTH + space;
-        if (pos > SCREEN_WIDTH) return;
+        if (pos > Config::width) return;
     }
 }
 
 // Renderiza una cadena almacenada en memoria Flash
-void drawText(int8_t x, int8_t y, const __FlashStringHelper *txt_p, uint8_t space) {
-    uint8_t pos = x;
+template <class Config>
+void drawText(typename Config::coord x, typename Config::coord y, const __FlashStringHelper *txt_p, uint8_t space) {
+    typename Config::pixel pos = x;
     uint8_t i = 0;
     char ch;
     while ((ch = F_char(txt_p, i)) != '\0') {
-        drawChar(pos, y, ch);
+        drawChar<Config>(pos, y, ch);
         i++;
         pos += CHAR_WIDTH + space;
     }
 }
 
-// Renderiza un número en pantalla (máximo 3 dígitos)
-void drawText(uint8_t x, uint8_t y, uint8_t num) {
-    char buf[4];
-    itoa(num, buf, 10);
-    drawText(x, y, buf);
+#ifdef RUN_RENDER_CHECK
+// ------------------------------------
+// Verificación del renderizado
+// ------------------------------------
+
+// Calcula un hash FNV-1a de todo el búfer de pantalla
+uint32_t getFrameHash() {
+    uint8_t *buf = display.getBuffer();
+    uint32_t hash = 2166136261UL;
+
+    for (uint16_t i = 0; i < SCREEN_WIDTH * (SCREEN_HEIGHT / 8); i++) {
+        hash ^= buf[i];
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+// Envía el búfer por Serial como imagen PBM (P1) para compararla en el ordenador
+void dumpFrame() {
+    uint8_t *buf = display.getBuffer();
+
+    Serial.println(F("P1"));
+    Serial.print(SCREEN_WIDTH);
+    Serial.print(' ');
+    Serial.println(SCREEN_HEIGHT);
+    for (uint8_t y = 0; y < SCREEN_HEIGHT; y++) {
+        for (uint8_t x = 0; x < SCREEN_WIDTH; x++) {
+            Serial.print(buf[(y / 8) * SCREEN_WIDTH + x] & (1 << (y & 7)) ? '1' : '0');
+        }
+        Serial.println();
+    }
+}
+#endif
+
+// Renderiza un número en pantalla (máximo 3 dígitos) escribiendo los glifos de los dígitos directamente
+template <class Config>
+void drawText(typename Config::pixel x, typename Config::pixel y, uint8_t num) {
+    uint8_t hundreds = 0, tens = 0;
+    while (num >= 100) { num -= 100; hundreds++; }
+    while (num >= 10) { num -= 10; tens++; }
+
+    // Los dígitos ocupan los glifos 1-10 de CHAR_MAP
+    if (hundreds) {
+        drawGlyph<Config>(x, y, hundreds + 1);
+        x += CHAR_WIDTH + 1;
+    }
+    if (hundreds || tens) {
+        drawGlyph<Config>(x, y, tens + 1);
+        x += CHAR_WIDTH + 1;
+    }
+    drawGlyph<Config>(x, y, num + 1);
 }
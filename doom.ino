@@ -6,29 +6,121 @@
 #include "types.h"
 #include "display.h"
 #include "sound.h"
+#include "profile.h"
+#ifdef RUN_RENDER_CHECK
+#include "render_check.h"
+#endif
+#ifdef BENCH_SIMAVR
+#include "bench.h"
+#endif
+#ifdef HOST_BUILD
+#include "render_pool.h"
+#endif
 
 // Macros para operaciones comunes
 #define swap(a, b)            do { typeof(a) temp = a; a = b; b = temp; } while (0)
 #define sign(a, b)            (double) (a > b ? 1 : (b > a ? -1 : 0))
 
 // Variables globales
+#if defined(BENCH_SIMAVR)
+uint8_t scene = BENCH;           // Escena actual
+#elif defined(RUN_RENDER_CHECK)
+uint8_t scene = RENDER_CHECK;    // Escena actual
+#else
 uint8_t scene = INTRO;           // Escena actual
+#endif
 bool exit_scene = false;         // Bandera para salir de una escena
 bool invert_screen = false;      // Bandera para invertir la pantalla
-uint8_t flash_screen = 0;        // Control de parpadeo de pantalla
 
-// Entidades y jugador
-Player player;                   // Estructura del jugador
-Entity entity[MAX_ENTITIES];     // Array de entidades dinámicas
-StaticEntity static_entity[MAX_STATIC_ENTITIES]; // Array de entidades estáticas
-uint8_t num_entities = 0;        // Número de entidades dinámicas activas
-uint8_t num_static_entities = 0; // Número de entidades estáticas activas
+// Estado de una partida: todo lo que cambia al jugar. El juego tiene una sola instancia (game); en el
+// host cada hilo puede simular la suya (host/simulate.cpp)
+struct GameState {
+    Player player;                   // Estructura del jugador
+    Entity entity[MAX_ENTITIES];     // Array de entidades dinámicas
+    StaticEntity static_entity[MAX_STATIC_ENTITIES]; // Array de entidades estáticas
+    uint8_t num_entities;            // Número de entidades dinámicas activas
+    uint8_t num_static_entities;     // Número de entidades estáticas activas
+    uint8_t door_table[DOOR_TABLE_SIZE]; // Índice + 1 en static_entity de la puerta de cada celda (0 = libre)
+#if defined(WALL_BITMAP) && !defined(WALL_BITMAP_PROGMEM)
+    uint8_t wall_bitmap[WALL_BITMAP_SIZE]; // Paredes del nivel actual: bit x & 7 del byte y * WALL_ROW_BYTES + x / 8
+#endif
+
+    // Campo de flujo: distancia en celdas hasta el jugador, 4 bits por celda
+    uint8_t flow_field[FLOW_SIZE * FLOW_SIZE / 2];
+    uint8_t flow_x;                  // Celda del nivel en la esquina de la ventana
+    uint8_t flow_y;
+    uint8_t flow_layer;              // Siguiente capa a expandir (FLOW_UNREACHED - 1 = completo)
+    uint8_t sight_next;              // Siguiente entidad a la que comprobar la línea de visión
+    uint8_t ai_frame;                // Contador de pasos para repartir la IA de los enemigos lejanos
+    EntityView view[MAX_ENTITIES];   // Entidades en el espacio de visión (updateViewCache())
+
+    // Vista y arma del jugador
+    uint8_t flash_screen;            // Control de parpadeo de pantalla
+    uint8_t gun_pos;                 // Posición del arma
+    bool gun_fired;                  // Estado del disparo
+    bool walk_sound_toggle;          // Alterna entre sonidos de caminar
+    double view_height;              // Altura de la vista
+    double jogging;                  // Intensidad del movimiento
+};
+
+#ifdef HOST_BUILD
+GameState default_game;
+thread_local GameState *active_game = &default_game; // Partida sobre la que juega el hilo actual
+#define game (*active_game)
+
+uint8_t render_threads = RENDER_THREADS ? RENDER_THREADS : RenderPool::hardwareThreads(); // Hilos de renderMapThreaded()
+#else
+GameState game;                  // Partida en curso
+#endif
+
+#ifdef COLUMN_CACHE
+// Columnas del último cuadro y pose de la cámara con la que se calcularon
+WallColumn column_cache[SCREEN_WIDTH / RES_DIVIDER];
+Coords column_cache_pos;
+Coords column_cache_dir;
+double column_cache_view_height;
+bool column_cache_valid = false;
+
+// Caché de columnas de la geometría de una configuración: solo la pantalla tiene una
+template <class Config, bool OnScreen = Config::geometry::on_screen>
+struct ColumnCache {
+    static WallColumnOf<typename Config::coord> *getColumns() { return NULL; }
+};
+
+template <class Config>
+struct ColumnCache<Config, true> {
+    static WallColumn *getColumns() { return column_cache; }
+};
+#endif
+
+// Carga de un nivel compilado por level_compiler.h
+template <class Level> void initializeLevel();
+
+// Renderizado parametrizado por RenderConfig (render_config.h); se instancia con RenderDefault
+template <class Config, class Spawner> RayHit castRay(const uint8_t level[], typename Config::pixel x, Spawner spawner);
+template <class Config> void drawWallColumn(typename Config::pixel x, WallColumnOf<typename Config::coord> *column);
+template <class Config> void drawColumn(typename Config::pixel x, RayHit *hit, double view_height);
+template <class Config> bool drawCachedColumns(double view_height);
+template <class Config, class Spawner> void renderColumns(const uint8_t level[], double view_height, typename Config::pixel from_x, typename Config::pixel to_x, Spawner spawner);
+template <class Config> void renderMap(const uint8_t level[], double view_height);
+template <class Config = RenderDefault> void renderGun(uint8_t gun_pos, double amount_jogging);
+template <class Config = RenderDefault> void renderHud();
+template <class Config = RenderDefault> void updateHud();
+template <class Config = RenderDefault> void renderStats();
+#ifdef HOST_BUILD
+template <class Config> void renderMapThreaded(const uint8_t level[], double view_height);
+template <class Config> void spawnVisibleEntities(const uint8_t level[], uint8_t sample);
+#endif
 
 // Configuración inicial del sistema
 void setup(void) {
     setupDisplay();    // Configuración de la pantalla
     input_setup();     // Configuración de los controles
     sound_init();      // Inicialización del sistema de sonido
+
+#ifdef PROFILE_STAGES
+    Serial.begin(115200);
+#endif
 }
 
 // Cambia a una nueva escena
@@ -37,18 +129,47 @@ void jumpTo(uint8_t target_scene) {
     exit_scene = true;     // Indica que se debe salir de la escena actual
 }
 
-// Inicializa el nivel a partir de su definición
-void initializeLevel(const uint8_t level[]) {
-    for (uint8_t y = LEVEL_HEIGHT - 1; y >= 0; y--) {
-        for (uint8_t x = 0; x < LEVEL_WIDTH; x++) {
-            uint8_t block = getBlockAt(level, x, y);
+// Inicializa el nivel con las tablas que level_compiler.h genera al compilar
+template <class Level>
+void initializeLevel() {
+    game.num_entities = 0;
+    game.num_static_entities = 0;
+    game.player = create_player(Level::player_x, Level::player_y); // Crea el jugador en el nivel
+
+    // Arma y vista en reposo
+    game.flash_screen = 0;
+    game.gun_pos = 0;
+    game.gun_fired = false;
+    game.walk_sound_toggle = false;
+    game.view_height = 0;
+    game.jogging = 0;
+
+#if defined(WALL_BITMAP) && !defined(WALL_BITMAP_PROGMEM)
+    memcpy_P(game.wall_bitmap, Level::Walls::data, WALL_BITMAP_SIZE);
+#endif
 
-            if (block == E_PLAYER) {
-                player = create_player(x, y); // Crea el jugador en el nivel
-                return;
-            }
+    for (const SpawnCell *cell = Level::Entities::data; ; cell++) {
+        uint8_t block = pgm_read_byte(&cell->block);
+        if (block == E_FLOOR) break;
+
+        if ((block == E_DOOR || block == E_LOCKEDDOOR) && game.num_static_entities < MAX_STATIC_ENTITIES) {
+            uint8_t x = pgm_read_byte(&cell->x);
+            uint8_t y = pgm_read_byte(&cell->y);
+            game.static_entity[game.num_static_entities] = create_door(block, x, y); // Registra la puerta cerrada
+            game.num_static_entities++;
         }
     }
+
+    buildDoorTable();
+    game.flow_layer = FLOW_UNREACHED; // Fuerza el reinicio del campo de flujo
+    invalidateColumnCache();
+}
+
+// Descarta las columnas guardadas; se llama cuando cambia algo que ven los rayos (nivel o puertas)
+void invalidateColumnCache() {
+#ifdef COLUMN_CACHE
+    column_cache_valid = false;
+#endif
 }
 
 // Obtiene un bloque del nivel según sus coordenadas
@@ -62,56 +183,146 @@ uint8_t getBlockAt(const uint8_t level[], uint8_t x, uint8_t y) {
            >> (!(x % 2) * 4) & 0b1111;
 }
 
+// Indica si la celda es una pared; con WALL_BITMAP basta un desplazamiento y una máscara
+bool isWallAt(const uint8_t level[], uint8_t x, uint8_t y) {
+#ifdef WALL_BITMAP
+    if (x >= LEVEL_WIDTH || y >= LEVEL_HEIGHT) return false;
+
+#ifdef WALL_BITMAP_PROGMEM
+    // Solo sto_level_1 tiene el mapa generado
+    if (level != sto_level_1) return getBlockAt(level, x, y) == E_WALL;
+    return pgm_read_byte(sto_level_1_walls + y * WALL_ROW_BYTES + (x >> 3)) & (1 << (x & 7));
+#else
+    return game.wall_bitmap[y * WALL_ROW_BYTES + (x >> 3)] & (1 << (x & 7));
+#endif
+#else
+    return getBlockAt(level, x, y) == E_WALL;
+#endif
+}
+
+// Obtiene un bloque del nivel. Con WALL_BITMAP las paredes salen del mapa de paredes y el suelo del mapa
+// de objetos de sto_level_1 (siempre en flash); solo las celdas con puertas, entidades o la salida leen el
+// nivel empaquetado
+uint8_t getWallOrBlockAt(const uint8_t level[], uint8_t x, uint8_t y) {
+#ifdef WALL_BITMAP
+    if (x >= LEVEL_WIDTH || y >= LEVEL_HEIGHT) return E_FLOOR;
+    if (level != sto_level_1) return getBlockAt(level, x, y);
+
+    uint16_t i = y * WALL_ROW_BYTES + (x >> 3);
+    uint8_t mask = 1 << (x & 7);
+#ifdef WALL_BITMAP_PROGMEM
+    if (pgm_read_byte(sto_level_1_walls + i) & mask) return E_WALL;
+#else
+    if (game.wall_bitmap[i] & mask) return E_WALL;
+#endif
+    if (!(pgm_read_byte(sto_level_1_objects + i) & mask)) return E_FLOOR;
+#endif
+    return getBlockAt(level, x, y);
+}
+
+#ifdef EMPTY_SPACE_SKIP
+// Tabla de distancias de un nivel, o NULL si no tiene (se genera con tools/level_tables.py)
+const uint8_t *getLevelDistance(const uint8_t level[]) {
+    return level == sto_level_1 ? sto_level_1_distance : NULL;
+}
+
+// Radios del rectángulo vacío centrado en la celda, como ((rx - 1) << 2) | (ry - 1); 0 si no hay nada que saltar
+uint8_t getDistanceAt(const uint8_t distance[], uint8_t x, uint8_t y) {
+    if (distance == NULL || x >= LEVEL_WIDTH || y >= LEVEL_HEIGHT) return 0;
+
+    return pgm_read_byte(distance + (((LEVEL_HEIGHT - 1 - y) * LEVEL_WIDTH + x) / 2))
+           >> (!(x % 2) * 4) & 0b1111;
+}
+#endif
+
 // Verifica si una entidad ya está activa
 bool isSpawned(UID uid) {
-    for (uint8_t i = 0; i < num_entities; i++) {
-        if (entity[i].uid == uid) return true;
+    for (uint8_t i = 0; i < game.num_entities; i++) {
+        if (game.entity[i].uid == uid) return true;
     }
     return false;
 }
 
 // Verifica si una entidad estática ya está activa
 bool isStatic(UID uid) {
-    for (uint8_t i = 0; i < num_static_entities; i++) {
-        if (static_entity[i].uid == uid) return true;
+    for (uint8_t i = 0; i < game.num_static_entities; i++) {
+        if (game.static_entity[i].uid == uid) return true;
     }
     return false;
 }
 
+// Posición inicial de una celda en la tabla de puertas
+uint8_t getDoorSlot(uint8_t x, uint8_t y) {
+    return (x + y * 7) & (DOOR_TABLE_SIZE - 1);
+}
+
+// Reconstruye la tabla de puertas por celda (sondeo lineal) a partir de static_entity
+void buildDoorTable() {
+    memset(game.door_table, 0, DOOR_TABLE_SIZE);
+
+    for (uint8_t i = 0; i < game.num_static_entities; i++) {
+        uint8_t type = uid_get_type(game.static_entity[i].uid);
+        if (type != E_DOOR && type != E_LOCKEDDOOR) continue;
+
+        uint8_t slot = getDoorSlot(game.static_entity[i].x, game.static_entity[i].y);
+        while (game.door_table[slot]) slot = (slot + 1) & (DOOR_TABLE_SIZE - 1);
+        game.door_table[slot] = i + 1;
+    }
+}
+
+// Busca la puerta de una celda sin recorrer static_entity
+StaticEntity *findDoor(uint8_t x, uint8_t y) {
+    uint8_t slot = getDoorSlot(x, y);
+
+    while (game.door_table[slot]) {
+        StaticEntity *door = &game.static_entity[game.door_table[slot] - 1];
+        if (door->x == x && door->y == y) return door;
+        slot = (slot + 1) & (DOOR_TABLE_SIZE - 1);
+    }
+    return NULL;
+}
+
+// Indica si una puerta impide el paso de una celda
+bool isDoorClosed(uint8_t x, uint8_t y) {
+    StaticEntity *door = findDoor(x, y);
+    return door && door->offset < DOOR_PASSABLE_OFFSET;
+}
+
 // Genera una nueva entidad en el mapa
 void spawnEntity(uint8_t type, uint8_t x, uint8_t y) {
-    if (num_entities >= MAX_ENTITIES) return; // Evita superar el límite
+    if (game.num_entities >= MAX_ENTITIES) return; // Evita superar el límite
 
     switch (type) {
         case E_ENEMY:
-            entity[num_entities] = create_enemy(x, y); // Crea un enemigo
-            num_entities++;
+            game.entity[game.num_entities] = create_enemy(x, y); // Crea un enemigo
+            game.num_entities++;
             break;
 
         case E_KEY:
-            entity[num_entities] = create_key(x, y); // Crea una llave
-            num_entities++;
+            game.entity[game.num_entities] = create_key(x, y); // Crea una llave
+            game.num_entities++;
             break;
 
         case E_MEDIKIT:
-            entity[num_entities] = create_medikit(x, y); // Crea un botiquín
-            num_entities++;
+            game.entity[game.num_entities] = create_medikit(x, y); // Crea un botiquín
+            game.num_entities++;
             break;
     }
 }
 
 // Genera un proyectil de fuego
 void spawnFireball(double x, double y) {
-    if (num_entities >= MAX_ENTITIES) return;
+    if (game.num_entities >= MAX_ENTITIES) return;
 
     UID uid = create_uid(E_FIREBALL, x, y); // Crea un UID único para el proyectil
 
     if (isSpawned(uid)) return; // No genera si ya existe
 
-    int16_t dir = FIREBALL_ANGLES + atan2(y - player.pos.y, x - player.pos.x) / PI * FIREBALL_ANGLES;
+    int16_t dir = FIREBALL_ANGLES + atan2(y - game.player.pos.y, x - game.player.pos.x) / PI * FIREBALL_ANGLES;
     if (dir < 0) dir += FIREBALL_ANGLES * 2;
-    entity[num_entities] = create_fireball(x, y, dir);
-    num_entities++;
+    game.entity[game.num_entities] = create_fireball(x, y, dir);
+    game.num_entities++;
+    playSound(fireball_snd);
 }
 
 // Elimina una entidad dinámica
@@ -119,14 +330,14 @@ void removeEntity(UID uid, bool makeStatic = false) {
     uint8_t i = 0;
     bool found = false;
 
-    while (i < num_entities) {
-        if (!found && entity[i].uid == uid) {
+    while (i < game.num_entities) {
+        if (!found && game.entity[i].uid == uid) {
             found = true; // Marca la entidad como encontrada
-            num_entities--;
+            game.num_entities--;
         }
 
         if (found) {
-            entity[i] = entity[i + 1]; // Reorganiza el array
+            game.entity[i] = game.entity[i + 1]; // Reorganiza el array
         }
 
         i++;
@@ -138,28 +349,30 @@ void removeStaticEntity(UID uid) {
     uint8_t i = 0;
     bool found = false;
 
-    while (i < num_static_entities) {
-        if (!found && static_entity[i].uid == uid) {
+    while (i < game.num_static_entities) {
+        if (!found && game.static_entity[i].uid == uid) {
             found = true; // Marca la entidad como encontrada
-            num_static_entities--;
+            game.num_static_entities--;
         }
 
         if (found) {
-            static_entity[i] = static_entity[i + 1]; // Reorganiza el array
+            game.static_entity[i] = game.static_entity[i + 1]; // Reorganiza el array
         }
 
         i++;
     }
+
+    if (found) buildDoorTable(); // Los índices de la tabla de puertas han cambiado
 }
 
 // Detecta colisiones con entidades u obstáculos
 UID detectCollision(const uint8_t level[], Coords *pos, double relative_x, double relative_y, bool only_walls = false) {
     uint8_t round_x = int(pos->x + relative_x);
     uint8_t round_y = int(pos->y + relative_y);
-    uint8_t block = getBlockAt(level, round_x, round_y);
+    uint8_t block = getWallOrBlockAt(level, round_x, round_y);
 
-    if (block == E_WALL) {
-        playSound(hit_wall_snd, HIT_WALL_SND_LEN);
+    if (block == E_WALL || ((block == E_DOOR || block == E_LOCKEDDOOR) && isDoorClosed(round_x, round_y))) {
+        playSound(hit_wall_snd);
         return create_uid(block, round_x, round_y);
     }
 
@@ -167,22 +380,22 @@ UID detectCollision(const uint8_t level[], Coords *pos, double relative_x, doubl
         return UID_null;
     }
 
-    for (uint8_t i = 0; i < num_entities; i++) {
-        if (&(entity[i].pos) == pos) {
+    for (uint8_t i = 0; i < game.num_entities; i++) {
+        if (&(game.entity[i].pos) == pos) {
             continue;
         }
 
-        uint8_t type = uid_get_type(entity[i].uid);
+        uint8_t type = uid_get_type(game.entity[i].uid);
 
-        if (type != E_ENEMY || entity[i].state == S_DEAD || entity[i].state == S_HIDDEN) {
+        if (type != E_ENEMY || game.entity[i].state == S_DEAD || game.entity[i].state == S_HIDDEN) {
             continue;
         }
 
-        Coords new_coords = { entity[i].pos.x - relative_x, entity[i].pos.y - relative_y };
+        Coords new_coords = { game.entity[i].pos.x - relative_x, game.entity[i].pos.y - relative_y };
         uint8_t distance = coords_distance(pos, &new_coords);
 
-        if (distance < ENEMY_COLLIDER_DIST && distance < entity[i].distance) {
-            return entity[i].uid;
+        if (distance < ENEMY_COLLIDER_DIST && distance < game.entity[i].distance) {
+            return game.entity[i].uid;
         }
     }
 
@@ -191,20 +404,24 @@ UID detectCollision(const uint8_t level[], Coords *pos, double relative_x, doubl
 
 // Dispara un arma
 void fire() {
-    playSound(shoot_snd, SHOOT_SND_LEN); // Reproduce el sonido del disparo
+    playSound(shoot_snd); // Reproduce el sonido del disparo
 
-    for (uint8_t i = 0; i < num_entities; i++) {
-        if (uid_get_type(entity[i].uid) != E_ENEMY || entity[i].state == S_DEAD || entity[i].state == S_HIDDEN) {
+    for (uint8_t i = 0; i < game.num_entities; i++) {
+        if (uid_get_type(game.entity[i].uid) != E_ENEMY || game.entity[i].state == S_DEAD || game.entity[i].state == S_HIDDEN) {
             continue; // Ignora entidades no válidas
         }
 
-        Coords transform = translateIntoView(&(entity[i].pos)); // Traduce las coordenadas al espacio de visión
-        if (abs(transform.x) < 20 && transform.y > 0) {
-            uint8_t damage = (double) min(GUN_MAX_DAMAGE, GUN_MAX_DAMAGE / (abs(transform.x) * entity[i].distance) / 5);
+        EntityView *view = &game.view[i];
+        if (!view->depth) continue; // Detrás de la cámara
+
+        // Desplazamiento lateral en la vista, de screen_x = HALF_WIDTH * (1 + x / depth)
+        double x = (double) abs(view->screen_x - HALF_WIDTH) * view->depth / (1 << VIEW_DEPTH_SHIFT) / HALF_WIDTH;
+        if (x < 20) {
+            uint8_t damage = (double) min(GUN_MAX_DAMAGE, GUN_MAX_DAMAGE / (x * game.entity[i].distance) / 5);
             if (damage > 0) {
-                entity[i].health = max(0, entity[i].health - damage); // Reduce la salud de la entidad
-                entity[i].state = S_HIT; // Cambia el estado de la entidad
-                entity[i].timer = 4; // Establece un temporizador para el estado
+                game.entity[i].health = max(0, game.entity[i].health - damage); // Reduce la salud de la entidad
+                game.entity[i].state = S_HIT; // Cambia el estado de la entidad
+                game.entity[i].timer = 4; // Establece un temporizador para el estado
             }
         }
     }
@@ -221,97 +438,261 @@ UID updatePosition(const uint8_t level[], Coords *pos, double relative_x, double
     return collide_x || collide_y || UID_null; // Retorna el UID de la colisión si ocurre
 }
 
+// Comprueba la línea de visión entre dos puntos recorriendo las celdas intermedias con el mismo
+// DDA que renderMap(), en punto fijo 8.8: las distancias a los bordes se comparan multiplicadas
+// por el avance del otro eje, así que no hace falta dividir.
+bool hasLineOfSight(const uint8_t level[], Coords *from, Coords *to) {
+    int16_t from_x = from->x * 256;
+    int16_t from_y = from->y * 256;
+    int16_t to_x = to->x * 256;
+    int16_t to_y = to->y * 256;
+
+    uint8_t map_x = from_x >> 8;
+    uint8_t map_y = from_y >> 8;
+    int8_t step_x = to_x >= from_x ? 1 : -1;
+    int8_t step_y = to_y >= from_y ? 1 : -1;
+    uint16_t delta_x = abs(to_x - from_x);
+    uint16_t delta_y = abs(to_y - from_y);
+
+    uint32_t side_x = (uint32_t) (step_x > 0 ? 256 - (from_x & 0xFF) : from_x & 0xFF) * delta_y;
+    uint32_t side_y = (uint32_t) (step_y > 0 ? 256 - (from_y & 0xFF) : from_y & 0xFF) * delta_x;
+    uint8_t cells = abs((to_x >> 8) - map_x) + abs((to_y >> 8) - map_y);
+
+    while (cells--) {
+        if (side_x < side_y) {
+            side_x += (uint32_t) delta_y << 8;
+            map_x += step_x;
+        } else {
+            side_y += (uint32_t) delta_x << 8;
+            map_y += step_y;
+        }
+
+        uint8_t block = getWallOrBlockAt(level, map_x, map_y);
+
+        if (block == E_WALL || ((block == E_DOOR || block == E_LOCKEDDOOR) && isDoorClosed(map_x, map_y))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Actualiza la línea de visión de SIGHT_CHECKS_PER_FRAME entidades por cuadro, por turnos
+void updateSight(const uint8_t level[]) {
+    for (uint8_t n = 0; n < SIGHT_CHECKS_PER_FRAME && n < game.num_entities; n++) {
+        if (game.sight_next >= game.num_entities) game.sight_next = 0;
+
+        Entity *e = &game.entity[game.sight_next];
+        e->sight = uid_get_type(e->uid) == E_ENEMY
+                   && e->distance < MAX_ENEMY_VIEW
+                   && hasLineOfSight(level, &(e->pos), &(game.player.pos));
+        game.sight_next++;
+    }
+}
+
+// Lee la distancia de una celda de la ventana del campo de flujo
+uint8_t getFlow(uint8_t i, uint8_t j) {
+    return game.flow_field[(j * FLOW_SIZE + i) / 2] >> ((i & 1) * 4) & 0b1111;
+}
+
+// Escribe la distancia de una celda de la ventana del campo de flujo
+void setFlow(uint8_t i, uint8_t j, uint8_t distance) {
+    uint8_t *b = &game.flow_field[(j * FLOW_SIZE + i) / 2];
+    if (i & 1) *b = (*b & 0b00001111) | distance << 4;
+    else *b = (*b & 0b11110000) | distance;
+}
+
+// Distancia al jugador desde una celda del nivel (FLOW_UNREACHED fuera de la ventana)
+uint8_t getFlowAt(uint8_t x, uint8_t y) {
+    uint8_t i = x - game.flow_x;
+    uint8_t j = y - game.flow_y;
+    if (i >= FLOW_SIZE || j >= FLOW_SIZE) return FLOW_UNREACHED;
+    return getFlow(i, j);
+}
+
+// Actualiza el campo de flujo hacia el jugador. Cuando el jugador cambia de celda se reinicia la
+// ventana y la búsqueda en anchura avanza como mucho FLOW_LAYERS_PER_FRAME capas por cuadro:
+// cada capa recorre la ventana y marca los vecinos libres de las celdas de la capa anterior, sin cola.
+// Las puertas cuentan como libres, ya que se abren al acercarse el jugador.
+void updateFlowField(const uint8_t level[]) {
+    uint8_t root_x = game.player.pos.x - FLOW_SIZE / 2;
+    uint8_t root_y = game.player.pos.y - FLOW_SIZE / 2;
+
+    if (root_x != game.flow_x || root_y != game.flow_y || game.flow_layer == FLOW_UNREACHED) {
+        game.flow_x = root_x;
+        game.flow_y = root_y;
+        memset(game.flow_field, 0xFF, sizeof(game.flow_field));
+        setFlow(FLOW_SIZE / 2, FLOW_SIZE / 2, 0);
+        game.flow_layer = 0;
+    }
+
+    for (uint8_t n = 0; n < FLOW_LAYERS_PER_FRAME && game.flow_layer < FLOW_UNREACHED - 1; n++) {
+        bool grown = false;
+
+        for (uint8_t j = 0; j < FLOW_SIZE; j++) {
+            for (uint8_t i = 0; i < FLOW_SIZE; i++) {
+                if (getFlow(i, j) != game.flow_layer) continue;
+
+                for (uint8_t k = 0; k < 4; k++) {
+                    uint8_t ni = i + (k == 0) - (k == 1);
+                    uint8_t nj = j + (k == 2) - (k == 3);
+
+                    if (ni >= FLOW_SIZE || nj >= FLOW_SIZE || getFlow(ni, nj) != FLOW_UNREACHED) continue;
+                    if (isWallAt(level, game.flow_x + ni, game.flow_y + nj)) continue;
+
+                    setFlow(ni, nj, game.flow_layer + 1);
+                    grown = true;
+                }
+            }
+        }
+
+        game.flow_layer = grown ? game.flow_layer + 1 : FLOW_UNREACHED - 1;
+    }
+}
+
+// Obtiene el centro de la celda vecina más cercana al jugador según el campo de flujo.
+// Devuelve false si la entidad está fuera del campo o en la celda del jugador.
+bool getFlowTarget(Coords *pos, Coords *target) {
+    uint8_t x = pos->x;
+    uint8_t y = pos->y;
+    uint8_t best = getFlowAt(x, y);
+
+    if (best == 0 || best == FLOW_UNREACHED) return false;
+
+    for (uint8_t k = 0; k < 4; k++) {
+        uint8_t nx = x + (k == 0) - (k == 1);
+        uint8_t ny = y + (k == 2) - (k == 3);
+        uint8_t distance = getFlowAt(nx, ny);
+
+        if (distance < best) {
+            best = distance;
+            *target = create_coords((double) nx + .5, (double) ny + .5);
+        }
+    }
+    return true;
+}
+
 // Actualiza el estado de todas las entidades activas
 void updateEntities(const uint8_t level[]) {
-    uint8_t i = 0;
-    while (i < num_entities) {
-        entity[i].distance = coords_distance(&(player.pos), &(entity[i].pos)); // Calcula la distancia al jugador
+    uint32_t start = micros();
+    updateSight(level);
+    game.ai_frame++;
 
-        if (entity[i].timer > 0) entity[i].timer--; // Decrementa el temporizador si está activo
+    uint8_t i = 0;
+    while (i < game.num_entities) {
+        game.entity[i].distance = coords_distance(&(game.player.pos), &(game.entity[i].pos)); // Calcula la distancia al jugador
 
-        if (entity[i].distance > MAX_ENTITY_DISTANCE) {
-            removeEntity(entity[i].uid); // Elimina entidades fuera del rango
+        if (game.entity[i].distance > MAX_ENTITY_DISTANCE) {
+            removeEntity(game.entity[i].uid); // Elimina entidades fuera del rango
             continue;
         }
 
-        if (entity[i].state == S_HIDDEN) {
+        if (game.entity[i].state == S_HIDDEN) {
             i++;
             continue;
         }
 
-        uint8_t type = uid_get_type(entity[i].uid);
+        uint8_t type = uid_get_type(game.entity[i].uid);
+
+        // Los enemigos lejanos y sin visión acumulan sus pasos y los aplican en su turno (fijo por
+        // UID, ya que entity[] se reordena) si queda presupuesto de tiempo o llevan AI_FAR_MAX_OWED
+        // pasos esperando, o en cuanto se acercan; el resto de entidades (y los ítems, que solo
+        // comprueban la proximidad) se actualizan en cada paso
+        if (game.entity[i].ai_owed < 255) game.entity[i].ai_owed++;
+        if (type == E_ENEMY && game.entity[i].distance > AI_NEAR_DIST && !game.entity[i].sight) {
+            bool turn = (uint8_t) (game.ai_frame + (game.entity[i].uid >> 4)) % AI_FAR_INTERVAL == 0; // Celda de origen
+            bool overdue = game.entity[i].ai_owed > AI_FAR_INTERVAL;
+            bool starved = game.entity[i].ai_owed >= AI_FAR_MAX_OWED;
+            if (!(turn || overdue) || (!starved && micros() - start >= AI_BUDGET_US)) {
+                i++;
+                continue;
+            }
+        }
+        uint8_t steps = game.entity[i].ai_owed;
+        game.entity[i].ai_owed = 0;
+
+        game.entity[i].timer = max(0, game.entity[i].timer - steps); // Decrementa el temporizador si está activo
+
         switch (type) {
             case E_ENEMY: {
                 // Gestión de enemigos
-                if (entity[i].health == 0) {
-                    if (entity[i].state != S_DEAD) {
-                        entity[i].state = S_DEAD;
-                        entity[i].timer = 6;
+                if (game.entity[i].health == 0) {
+                    if (game.entity[i].state != S_DEAD) {
+                        game.entity[i].state = S_DEAD;
+                        game.entity[i].timer = 6;
+                        playSound(enemy_death_snd);
                     }
-                } else if (entity[i].state == S_HIT) {
-                    if (entity[i].timer == 0) {
-                        entity[i].state = S_ALERT;
-                        entity[i].timer = 40;
+                } else if (game.entity[i].state == S_HIT) {
+                    if (game.entity[i].timer == 0) {
+                        game.entity[i].state = S_ALERT;
+                        game.entity[i].timer = 40;
                     }
-                } else if (entity[i].state == S_FIRING) {
-                    if (entity[i].timer == 0) {
-                        entity[i].state = S_ALERT;
-                        entity[i].timer = 40;
+                } else if (game.entity[i].state == S_FIRING) {
+                    if (game.entity[i].timer == 0) {
+                        game.entity[i].state = S_ALERT;
+                        game.entity[i].timer = 40;
                     }
                 } else {
-                    // Movimiento y acciones de enemigos
-                    if (entity[i].distance > ENEMY_MELEE_DIST && entity[i].distance < MAX_ENEMY_VIEW) {
-                        if (entity[i].state != S_ALERT) {
-                            entity[i].state = S_ALERT;
-                            entity[i].timer = 20;
-                        } else if (entity[i].timer == 0) {
-                            spawnFireball(entity[i].pos.x, entity[i].pos.y); // Lanza un proyectil
-                            entity[i].state = S_FIRING;
-                            entity[i].timer = 6;
+                    // Movimiento y acciones de enemigos: alertarse y disparar requieren ver al jugador
+                    if (
+                        game.entity[i].distance > ENEMY_MELEE_DIST && game.entity[i].distance < MAX_ENEMY_VIEW
+                        && (game.entity[i].sight || game.entity[i].state == S_ALERT)
+                    ) {
+                        if (game.entity[i].state != S_ALERT) {
+                            if (game.entity[i].state == S_STAND) playSound(enemy_alert_snd); // Acaba de ver al jugador
+                            game.entity[i].state = S_ALERT;
+                            game.entity[i].timer = 20;
+                        } else if (game.entity[i].timer == 0 && game.entity[i].sight) {
+                            spawnFireball(game.entity[i].pos.x, game.entity[i].pos.y); // Lanza un proyectil
+                            game.entity[i].state = S_FIRING;
+                            game.entity[i].timer = 6;
                         } else {
+                            // Sigue el campo de flujo; fuera de él se dirige directamente al jugador
+                            Coords target = game.player.pos;
+                            getFlowTarget(&(game.entity[i].pos), &target);
+
                             updatePosition(
                                 level,
-                                &(entity[i].pos),
-                                sign(player.pos.x, entity[i].pos.x) * ENEMY_SPEED * delta,
-                                sign(player.pos.y, entity[i].pos.y) * ENEMY_SPEED * delta,
+                                &(game.entity[i].pos),
+                                sign(target.x, game.entity[i].pos.x) * ENEMY_SPEED * steps,
+                                sign(target.y, game.entity[i].pos.y) * ENEMY_SPEED * steps,
                                 true
                             );
                         }
-                    } else if (entity[i].distance <= ENEMY_MELEE_DIST) {
-                        if (entity[i].state != S_MELEE) {
-                            entity[i].state = S_MELEE;
-                            entity[i].timer = 10;
-                        } else if (entity[i].timer == 0) {
-                            player.health = max(0, player.health - ENEMY_MELEE_DAMAGE); // Reduce la salud del jugador
-                            entity[i].timer = 14;
-                            flash_screen = 1;
+                    } else if (game.entity[i].distance <= ENEMY_MELEE_DIST) {
+                        if (game.entity[i].state != S_MELEE) {
+                            game.entity[i].state = S_MELEE;
+                            game.entity[i].timer = 10;
+                        } else if (game.entity[i].timer == 0) {
+                            game.player.health = max(0, game.player.health - ENEMY_MELEE_DAMAGE); // Reduce la salud del jugador
+                            game.entity[i].timer = 14;
+                            game.flash_screen = 1;
                             updateHud();
                         }
                     } else {
-                        entity[i].state = S_STAND; // El enemigo se detiene
+                        game.entity[i].state = S_STAND; // El enemigo se detiene
                     }
                 }
                 break;
             }
             case E_FIREBALL: {
                 // Gestión de proyectiles
-                if (entity[i].distance < FIREBALL_COLLIDER_DIST) {
-                    player.health = max(0, player.health - ENEMY_FIREBALL_DAMAGE); // Reduce la salud del jugador
-                    flash_screen = 1;
+                if (game.entity[i].distance < FIREBALL_COLLIDER_DIST) {
+                    game.player.health = max(0, game.player.health - ENEMY_FIREBALL_DAMAGE); // Reduce la salud del jugador
+                    game.flash_screen = 1;
                     updateHud();
-                    removeEntity(entity[i].uid);
+                    removeEntity(game.entity[i].uid);
                     continue;
                 } else {
                     UID collided = updatePosition(
                         level,
-                        &(entity[i].pos),
-                        cos((double) entity[i].health / FIREBALL_ANGLES * PI) * FIREBALL_SPEED,
-                        sin((double) entity[i].health / FIREBALL_ANGLES * PI) * FIREBALL_SPEED,
+                        &(game.entity[i].pos),
+                        cos((double) game.entity[i].health / FIREBALL_ANGLES * PI) * FIREBALL_SPEED,
+                        sin((double) game.entity[i].health / FIREBALL_ANGLES * PI) * FIREBALL_SPEED,
                         true
                     );
 
                     if (collided) {
-                        removeEntity(entity[i].uid);
+                        removeEntity(game.entity[i].uid);
                         continue;
                     }
                 }
@@ -319,23 +700,23 @@ void updateEntities(const uint8_t level[]) {
             }
             case E_MEDIKIT: {
                 // Gestión de botiquines
-                if (entity[i].distance < ITEM_COLLIDER_DIST) {
-                    playSound(medkit_snd, MEDKIT_SND_LEN);
-                    entity[i].state = S_HIDDEN;
-                    player.health = min(100, player.health + 50); // Restaura la salud del jugador
+                if (game.entity[i].distance < ITEM_COLLIDER_DIST) {
+                    playSound(medkit_snd);
+                    game.entity[i].state = S_HIDDEN;
+                    game.player.health = min(100, game.player.health + 50); // Restaura la salud del jugador
                     updateHud();
-                    flash_screen = 1;
+                    game.flash_screen = 1;
                 }
                 break;
             }
             case E_KEY: {
                 // Gestión de llaves
-                if (entity[i].distance < ITEM_COLLIDER_DIST) {
-                    playSound(get_key_snd, GET_KEY_SND_LEN);
-                    entity[i].state = S_HIDDEN;
-                    player.keys++; // Incrementa el contador de llaves del jugador
+                if (game.entity[i].distance < ITEM_COLLIDER_DIST) {
+                    playSound(get_key_snd);
+                    game.entity[i].state = S_HIDDEN;
+                    game.player.keys++; // Incrementa el contador de llaves del jugador
                     updateHud();
-                    flash_screen = 1;
+                    game.flash_screen = 1;
                 }
                 break;
             }
@@ -344,101 +725,475 @@ void updateEntities(const uint8_t level[]) {
     }
 }
 
-// Renderiza el mapa, trazando rayos desde el jugador
-void renderMap(const uint8_t level[], double view_height) {
-    UID last_uid;
-
-    for (uint8_t x = 0; x < SCREEN_WIDTH; x += RES_DIVIDER) {
-        double camera_x = 2 * (double)x / SCREEN_WIDTH - 1;
-        double ray_x = player.dir.x + player.plane.x * camera_x;
-        double ray_y = player.dir.y + player.plane.y * camera_x;
-        uint8_t map_x = uint8_t(player.pos.x);
-        uint8_t map_y = uint8_t(player.pos.y);
-        Coords map_coords = {player.pos.x, player.pos.y};
-        double delta_x = abs(1 / ray_x);
-        double delta_y = abs(1 / ray_y);
-
-        int8_t step_x;
-        int8_t step_y;
-        double side_x;
-        double side_y;
-
-        if (ray_x < 0) {
-            step_x = -1;
-            side_x = (player.pos.x - map_x) * delta_x;
-        } else {
-            step_x = 1;
-            side_x = (map_x + 1.0 - player.pos.x) * delta_x;
+// Abre las puertas cercanas al jugador (gastando una llave en las cerradas con llave),
+// cierra las lejanas y avanza su animación de apertura
+void updateDoors() {
+    uint8_t player_x = game.player.pos.x;
+    uint8_t player_y = game.player.pos.y;
+
+    for (uint8_t i = 0; i < game.num_static_entities; i++) {
+        StaticEntity *door = &game.static_entity[i];
+        uint8_t type = uid_get_type(door->uid);
+        if (type != E_DOOR && type != E_LOCKEDDOOR) continue;
+
+        uint8_t cells = max(abs(player_x - door->x), abs(player_y - door->y));
+
+        if (door->state != S_OPEN && cells <= DOOR_OPEN_CELLS) {
+            if (type == E_LOCKEDDOOR) {
+                if (game.player.keys == 0) continue;
+                game.player.keys--;
+                door->uid = create_uid(E_DOOR, door->x, door->y); // Queda desbloqueada
+                updateHud();
+            }
+            door->state = S_OPEN;
+            playSound(door_snd);
+        } else if (door->state == S_OPEN && cells >= DOOR_CLOSE_CELLS) {
+            door->state = S_CLOSE;
+            playSound(door_snd);
         }
 
-        if (ray_y < 0) {
-            step_y = -1;
-            side_y = (player.pos.y - map_y) * delta_y;
+        uint8_t offset = door->offset;
+        if (door->state == S_OPEN) door->offset = min(255, door->offset + DOOR_SPEED);
+        else door->offset = max(0, door->offset - DOOR_SPEED);
+
+        if (door->offset != offset) invalidateColumnCache();
+    }
+}
+
+#ifdef TEXTURED_WALLS
+// Elige la textura de una celda de pared; algunas celdas usan el panel para romper la repetición
+uint8_t getWallTexture(uint8_t x, uint8_t y) {
+    return ((x * 7 + y * 3) & 7) == 0 ? 1 : 0;
+}
+
+// Textura de un índice: las de bmp_wall_bits y, tras ellas, la de las puertas
+const uint8_t *getTextureBitmap(uint8_t texture) {
+    return texture < BMP_WALL_COUNT ? bmp_wall_bits + texture * BMP_TEXTURE_BYTES : bmp_door_bits;
+}
+#endif
+
+// Genera la entidad de una celda que cruza un rayo, salvo si es la última generada o ya existe
+void spawnRayEntity(UID *last_uid, uint8_t block, uint8_t x, uint8_t y) {
+    UID uid = create_uid(block, x, y);
+    if (*last_uid != uid && !isSpawned(uid)) {
+        spawnEntity(block, x, y);
+        *last_uid = uid;
+    }
+}
+
+#ifdef HOST_BUILD
+// Renderizado con hilos: la celda se guarda y se genera después, en el orden de las columnas
+void spawnRayEntity(std::vector<SpawnCell> *cells, uint8_t block, uint8_t x, uint8_t y) {
+    cells->push_back({block, x, y});
+}
+#endif
+
+// Lanza el rayo de la columna x de la pantalla y pasa a spawner las entidades que encuentra por el camino
+template <class Config, class Spawner>
+RayHit castRay(const uint8_t level[], typename Config::pixel x, Spawner spawner) {
+    double camera_x = 2 * (double)x / Config::width - 1;
+    double ray_x = game.player.dir.x + game.player.plane.x * camera_x;
+    double ray_y = game.player.dir.y + game.player.plane.y * camera_x;
+    uint8_t map_x = uint8_t(game.player.pos.x);
+    uint8_t map_y = uint8_t(game.player.pos.y);
+    Coords map_coords = {game.player.pos.x, game.player.pos.y};
+    double delta_x = abs(1 / ray_x);
+    double delta_y = abs(1 / ray_y);
+
+    int8_t step_x;
+    int8_t step_y;
+    double side_x;
+    double side_y;
+
+    if (ray_x < 0) {
+        step_x = -1;
+        side_x = (game.player.pos.x - map_x) * delta_x;
+    } else {
+        step_x = 1;
+        side_x = (map_x + 1.0 - game.player.pos.x) * delta_x;
+    }
+
+    if (ray_y < 0) {
+        step_y = -1;
+        side_y = (game.player.pos.y - map_y) * delta_y;
+    } else {
+        step_y = 1;
+        side_y = (map_y + 1.0 - game.player.pos.y) * delta_y;
+    }
+
+    uint8_t depth = 0;
+    RayHit hit;
+    hit.hit = false;
+    hit.door = false;
+    StaticEntity *door = NULL;
+
+#ifdef EMPTY_SPACE_SKIP
+    const uint8_t *distance = getLevelDistance(level);
+#endif
+
+    profileRay();
+
+    while (!hit.hit && depth < Config::max_render_depth) {
+        if (side_x < side_y) {
+            side_x += delta_x;
+            map_x += step_x;
+            hit.side = 0;
         } else {
-            step_y = 1;
-            side_y = (map_y + 1.0 - player.pos.y) * delta_y;
+            side_y += delta_y;
+            map_y += step_y;
+            hit.side = 1;
         }
 
-        uint8_t depth = 0;
-        bool hit = 0;
-        bool side;
-
-        while (!hit && depth < MAX_RENDER_DEPTH) {
-            if (side_x < side_y) {
-                side_x += delta_x;
-                map_x += step_x;
-                side = 0;
+#ifdef EMPTY_SPACE_SKIP
+        // Las celdas vacías no generan entidades ni detienen el rayo. Si la celda es el centro de un
+        // rectángulo vacío, el rayo salta de una vez a la última celda del rectángulo que cruza (le
+        // quedan inside_x pasos en x e inside_y en y hasta el borde) y el siguiente paso sale de él
+        uint8_t empty_box = getDistanceAt(distance, map_x, map_y);
+        profileRead();
+
+        if (empty_box) {
+            uint8_t inside_x = empty_box >> 2;
+            uint8_t inside_y = empty_box & 0b11;
+            uint8_t steps_x = inside_x;
+            uint8_t steps_y = inside_y;
+
+            // Distancias a las que el rayo sale del rectángulo por cada eje
+            double exit_x = inside_x ? side_x + inside_x * delta_x : side_x;
+            double exit_y = inside_y ? side_y + inside_y * delta_y : side_y;
+
+            if (exit_x < exit_y) {
+                // Sale por x: solo da los pasos en y que llegan antes (side_y <= exit_x, como en el DDA)
+                double count = side_y <= exit_x ? (exit_x - side_y) / delta_y + 1 : 0;
+                if (count < inside_y) steps_y = count;
             } else {
-                side_y += delta_y;
-                map_y += step_y;
-                side = 1;
+                // Sale por y: los pasos en x que llegan antes (side_x < exit_y)
+                double count = side_x < exit_y ? (exit_y - side_x) / delta_x : 0;
+                if (count < inside_x) {
+                    steps_x = count;
+                    if (steps_x < count) steps_x++;
+                }
+            }
+
+            if (steps_x) {
+                map_x += step_x * steps_x;
+                side_x += steps_x * delta_x;
+            }
+            if (steps_y) {
+                map_y += step_y * steps_y;
+                side_y += steps_y * delta_y;
             }
+            depth += 1 + steps_x + steps_y;
+            continue;
+        }
+#endif
 
-            uint8_t block = getBlockAt(level, map_x, map_y);
+        uint8_t block = getWallOrBlockAt(level, map_x, map_y);
+        profileRead();
 
-            if (block == E_WALL) {
-                hit = 1;
+        if (block == E_WALL) {
+            hit.hit = true;
+        } else if (block == E_DOOR || block == E_LOCKEDDOOR) {
+            // Puerta: losa a mitad de la celda, perpendicular al pasillo, desplazada según su apertura
+            StaticEntity *cell_door = findDoor(map_x, map_y);
+            double door_x;
+
+            if (isWallAt(level, map_x, map_y + 1)) {
+                hit.distance = (map_x + 0.5 - game.player.pos.x) / ray_x;
+                door_x = game.player.pos.y + hit.distance * ray_y - map_y;
+                hit.side = 0;
             } else {
-                if (block == E_ENEMY || (block & 0b00001000)) {
-                    if (coords_distance(&(player.pos), &map_coords) < MAX_ENTITY_DISTANCE) {
-                        UID uid = create_uid(block, map_x, map_y);
-                        if (last_uid != uid && !isSpawned(uid)) {
-                            spawnEntity(block, map_x, map_y);
-                            last_uid = uid;
-                        }
-                    }
+                hit.distance = (map_y + 0.5 - game.player.pos.y) / ray_y;
+                door_x = game.player.pos.x + hit.distance * ray_x - map_x;
+                hit.side = 1;
+            }
+
+            if (cell_door && hit.distance > 0 && door_x < 1 && door_x * 256 >= cell_door->offset) {
+                door = cell_door;
+                hit.hit = true;
+            }
+        } else {
+            if (block == E_ENEMY || (block & 0b00001000)) {
+                if (coords_distance(&(game.player.pos), &map_coords) < MAX_ENTITY_DISTANCE) {
+                    spawnRayEntity(spawner, block, map_x, map_y);
                 }
             }
+        }
+
+        depth++;
+    }
+
+    if (!hit.hit) return hit;
+
+    hit.map_x = map_x;
+    hit.map_y = map_y;
+
+    // En las puertas la distancia ya es la del impacto con la losa
+    if (door) {
+        hit.door = true;
+        hit.door_offset = door->offset;
+    } else if (hit.side == 0) {
+        hit.distance = (map_x - game.player.pos.x + (1 - step_x) / 2) / ray_x;
+    } else {
+        hit.distance = (map_y - game.player.pos.y + (1 - step_y) / 2) / ray_y;
+    }
+
+#ifdef TEXTURED_WALLS
+    // Coordenada del impacto a lo largo de la pared, con la distancia sin recortar
+    hit.wall = hit.side == 0 ? game.player.pos.y + hit.distance * ray_y : game.player.pos.x + hit.distance * ray_x;
+    hit.flip = (hit.side == 0 && ray_x > 0) || (hit.side == 1 && ray_y < 0);
+#endif
 
-            depth++;
+    return hit;
+}
+
+// Dibuja una columna de pared ya calculada, con el suelo y el techo si están activos
+template <class Config>
+void drawWallColumn(typename Config::pixel x, WallColumnOf<typename Config::coord> *column) {
+    if (column->start_y < Config::render_height) {
+#ifdef TEXTURED_WALLS
+        drawTexturedVLine<Config>(
+            x,
+            column->start_y,
+            column->end_y,
+            getTextureBitmap(column->texture >> 5),
+            column->texture & (BMP_TEXTURE_SIZE - 1),
+            column->intensity
+        );
+#else
+        drawVLine<Config>(x, column->start_y, column->end_y, column->intensity);
+#endif
+    }
+#ifdef FLOOR_CEILING
+    drawFloorCeiling<Config>(x, column->start_y, column->end_y);
+#endif
+}
+
+// Dibuja la columna x de la pared a partir del impacto de su rayo y actualiza el z-buffer
+template <class Config>
+void drawColumn(typename Config::pixel x, RayHit *hit, double view_height) {
+    WallColumnOf<typename Config::coord> column;
+
+    if (!hit->hit) {
+        column.start_y = Config::render_height; // Sin pared: toda la columna es suelo y techo
+        column.end_y = Config::render_height;
+    } else {
+        double distance = max(1, hit->distance);
+        FrameTarget<typename Config::geometry>::getDepth()[x / Config::z_res_divider] = min(distance * Config::distance_multiplier, 255);
+
+        typename Config::pixel line_height = Config::render_height / distance;
+
+        column.start_y = view_height / distance - line_height / 2 + Config::render_height / 2;
+        column.end_y = view_height / distance + line_height / 2 + Config::render_height / 2;
+        column.intensity = GRADIENT_COUNT - int(distance / Config::max_render_depth * GRADIENT_COUNT) - hit->side * 2;
+
+#ifdef TEXTURED_WALLS
+        // Posición (0..1) dentro de la celda; invierte la columna en las caras vistas desde el otro lado
+        double wall_x = hit->wall - floor(hit->wall);
+        if (hit->door) wall_x -= hit->door_offset / 256.0; // La textura se desliza con la puerta
+
+        uint8_t tex_x = wall_x * BMP_TEXTURE_SIZE;
+        if (hit->flip) tex_x = BMP_TEXTURE_SIZE - 1 - tex_x;
+
+        uint8_t texture = hit->door ? BMP_WALL_COUNT : getWallTexture(hit->map_x, hit->map_y);
+        column.texture = texture << 5 | (tex_x & (BMP_TEXTURE_SIZE - 1));
+#endif
+    }
+
+    drawWallColumn<Config>(x, &column);
+
+#ifdef COLUMN_CACHE
+    if (Config::geometry::on_screen) ColumnCache<Config>::getColumns()[x / Config::res_divider] = column;
+#endif
+}
+
+#ifdef COLUMN_LOD
+// Columnas (de RES_DIVIDER píxeles) que cubre el rayo de la columna x: las paredes lejanas fuera
+// del centro de la pantalla se muestrean cada LOD_SPAN columnas
+template <class Config>
+uint8_t getColumnSpan(typename Config::pixel x, RayHit *hit) {
+    constexpr uint16_t center_width = LOD_CENTER_WIDTH * Config::width / SCREEN_WIDTH;
+
+    if (!hit->hit || hit->distance < LOD_DISTANCE) return 1;
+    if (x + LOD_SPAN * Config::res_divider > (Config::width - center_width) / 2 && x < (Config::width + center_width) / 2) return 1;
+    return min(LOD_SPAN, (Config::width - x) / Config::res_divider);
+}
+
+// Indica si las columnas entre dos rayos se pueden interpolar: ambos sin pared, o ambos sobre el
+// mismo plano de pared (sin puertas) y con distancias parecidas
+bool canInterpolate(RayHit *a, RayHit *b) {
+    if (!a->hit || !b->hit) return a->hit == b->hit;
+    if (a->door || b->door || a->side != b->side) return false;
+    if ((a->side == 0 ? a->map_x != b->map_x : a->map_y != b->map_y)) return false;
+    return abs(a->distance - b->distance) <= LOD_MAX_DELTA;
+}
+
+// Impacto en la fracción t entre dos rayos del mismo plano: 1 / distancia (y la coordenada de la
+// pared dividida por la distancia) varían linealmente a lo largo de la pantalla
+RayHit interpolateHit(RayHit *a, RayHit *b, double t) {
+    RayHit hit = *a;
+    if (!hit.hit) return hit;
+
+    double inv_distance = (1 - t) / a->distance + t / b->distance;
+    hit.distance = 1 / inv_distance;
+
+#ifdef TEXTURED_WALLS
+    hit.wall = ((1 - t) * a->wall / a->distance + t * b->wall / b->distance) / inv_distance;
+    if (hit.side == 0) hit.map_y = hit.wall;
+    else hit.map_x = hit.wall;
+#endif
+
+    return hit;
+}
+#endif
+
+#ifdef COLUMN_CACHE
+// Con la cámara quieta redibuja las columnas guardadas sin lanzar rayos (el z-buffer del cuadro
+// anterior sigue siendo válido) y devuelve true; si no, guarda la pose del cuadro que se va a lanzar
+template <class Config>
+bool drawCachedColumns(double view_height) {
+    static_assert(!Config::geometry::on_screen || Config::res_divider >= RES_DIVIDER, "column_cache tiene SCREEN_WIDTH / RES_DIVIDER columnas");
+
+    if (!Config::geometry::on_screen) return false;
+
+    if (
+        column_cache_valid && column_cache_view_height == view_height
+        && column_cache_pos.x == game.player.pos.x && column_cache_pos.y == game.player.pos.y
+        && column_cache_dir.x == game.player.dir.x && column_cache_dir.y == game.player.dir.y
+    ) {
+        for (typename Config::pixel x = 0; x < Config::width; x += Config::res_divider) {
+            drawWallColumn<Config>(x, &ColumnCache<Config>::getColumns()[x / Config::res_divider]);
         }
+        return true;
+    }
 
-        if (hit) {
-            double distance;
+    column_cache_pos = game.player.pos;
+    column_cache_dir = game.player.dir;
+    column_cache_view_height = view_height;
+    column_cache_valid = true;
+    return false;
+}
+#endif
 
-            if (side == 0) {
-                distance = max(1, (map_x - player.pos.x + (1 - step_x) / 2) / ray_x);
-            } else {
-                distance = max(1, (map_y - player.pos.y + (1 - step_y) / 2) / ray_y);
-            }
+// Lanza y dibuja un rayo por columna entre from_x y to_x
+template <class Config, class Spawner>
+void renderColumns(const uint8_t level[], double view_height, typename Config::pixel from_x, typename Config::pixel to_x, Spawner spawner) {
+    for (typename Config::pixel x = from_x; x < to_x; x += Config::res_divider) {
+        RayHit hit = castRay<Config>(level, x, spawner);
+        drawColumn<Config>(x, &hit, view_height);
+    }
+}
 
-            zbuffer[x / Z_RES_DIVIDER] = min(distance * DISTANCE_MULTIPLIER, 255);
+// Renderiza el mapa, trazando rayos desde el jugador, con la configuración de render_config.h
+template <class Config>
+void renderMap(const uint8_t level[], double view_height) {
+    UID last_uid = UID_null;
 
-            uint8_t line_height = RENDER_HEIGHT / distance;
+#ifdef COLUMN_CACHE
+    if (drawCachedColumns<Config>(view_height)) return;
+#endif
 
-            drawVLine(
-                x,
-                view_height / distance - line_height / 2 + RENDER_HEIGHT / 2,
-                view_height / distance + line_height / 2 + RENDER_HEIGHT / 2,
-                GRADIENT_COUNT - int(distance / MAX_RENDER_DEPTH * GRADIENT_COUNT) - side * 2
-            );
+#ifdef COLUMN_LOD
+    // Cada rayo se lanza una vez: el del final de un tramo es el del principio del siguiente
+    RayHit hit = castRay<Config>(level, 0, &last_uid);
+
+    for (typename Config::pixel x = 0; x < Config::width;) {
+        uint8_t span = getColumnSpan<Config>(x, &hit);
+        typename Config::pixel next_x = x + span * Config::res_divider;
+        RayHit next_hit;
+        if (next_x < Config::width || span > 1) next_hit = castRay<Config>(level, next_x, &last_uid);
+
+        if (span == 1) {
+            drawColumn<Config>(x, &hit, view_height);
+        } else if (canInterpolate(&hit, &next_hit)) {
+            for (uint8_t i = 0; i < span; i++) {
+                RayHit column_hit = interpolateHit(&hit, &next_hit, (double) i / span);
+                drawColumn<Config>(x + i * Config::res_divider, &column_hit, view_height);
+            }
+        } else {
+            // Los extremos no coinciden: se refina el tramo con un rayo por columna
+            drawColumn<Config>(x, &hit, view_height);
+            for (uint8_t i = 1; i < span; i++) {
+                RayHit column_hit = castRay<Config>(level, x + i * Config::res_divider, &last_uid);
+                drawColumn<Config>(x + i * Config::res_divider, &column_hit, view_height);
+            }
         }
+
+        x = next_x;
+        hit = next_hit;
     }
+#else
+    renderColumns<Config>(level, view_height, 0, Config::width, &last_uid);
+#endif
 }
 
+#ifdef HOST_BUILD
+// Renderiza el mapa repartiendo tramos contiguos de columnas entre render_threads hilos; con un solo
+// hilo usa renderMap(), y el grupo de hilos se vuelve a crear si cambia render_threads. Cada tramo
+// empieza en un múltiplo de las entradas del z-buffer, así que cada hilo escribe sus propias
+// columnas de la imagen, el z-buffer y column_cache en el mismo orden que renderMap().
+// Las entidades que cruzan los rayos se generan después, tramo a tramo y en orden de columna,
+// y el resultado es idéntico al de renderMap() (host/render_bench.cpp lo comprueba). Los hilos del
+// grupo dibujan la partida activa del llamante, y cada hilo que llama tiene su propio grupo, así que
+// varias simulaciones pueden renderizar a la vez. COLUMN_LOD decide los tramos de rayos sobre toda
+// la pantalla, así que con él se usa renderMap().
+template <class Config>
+void renderMapThreaded(const uint8_t level[], double view_height) {
+#ifdef COLUMN_LOD
+    renderMap<Config>(level, view_height);
+#else
+    thread_local std::unique_ptr<RenderPool> pool;
+    thread_local std::vector<std::vector<SpawnCell>> cells;
+
+    if (render_threads < 2) {
+        renderMap<Config>(level, view_height);
+        return;
+    }
+    if (!pool || pool->size() != render_threads) {
+        pool.reset(new RenderPool(render_threads));
+        cells.resize(render_threads);
+    }
+
+#ifdef COLUMN_CACHE
+    if (drawCachedColumns<Config>(view_height)) return;
+#endif
+
+    constexpr uint8_t unit = max(Config::res_divider, Config::z_res_divider);
+    static_assert(Config::width % unit == 0, "los tramos deben cubrir toda la imagen");
+    constexpr uint16_t units = Config::width / unit;
+
+    uint8_t threads = render_threads;
+    GameState *caller_game = active_game;
+    std::vector<std::vector<SpawnCell>> &thread_cells = cells; // [&] no captura variables thread_local
+    pool->run([&](uint8_t thread) {
+        active_game = caller_game; // Los hilos del grupo empiezan en default_game
+        typename Config::pixel from_x = units * thread / threads * unit;
+        typename Config::pixel to_x = units * (thread + 1) / threads * unit;
+
+        thread_cells[thread].clear();
+        renderColumns<Config>(level, view_height, from_x, to_x, &thread_cells[thread]);
+    });
+
+    UID last_uid = UID_null;
+    for (uint8_t thread = 0; thread < threads; thread++) {
+        for (const SpawnCell &cell : cells[thread]) spawnRayEntity(&last_uid, cell.block, cell.x, cell.y);
+    }
+#endif
+}
+
+// Lanza sin dibujar uno de cada sample rayos de la pantalla para generar las entidades que se verían;
+// lo usan las simulaciones sin pantalla (host/simulate.cpp), en las que los enemigos aparecen igual que al jugar
+template <class Config>
+void spawnVisibleEntities(const uint8_t level[], uint8_t sample) {
+    UID last_uid = UID_null;
+    for (uint16_t x = 0; x < Config::width; x += Config::res_divider * sample) {
+        castRay<Config>(level, x, &last_uid);
+    }
+}
+#endif
+
 // Ordena las entidades según su distancia al jugador para el renderizado
-uint8_t sortEntities() {
-    uint8_t gap = num_entities;
+void sortEntities() {
+    uint8_t gap = game.num_entities;
     bool swapped = false;
 
     while (gap > 1 || swapped) {
@@ -448,153 +1203,197 @@ uint8_t sortEntities() {
 
         swapped = false;
 
-        for (uint8_t i = 0; i < num_entities - gap; i++) {
+        for (uint8_t i = 0; i < game.num_entities - gap; i++) {
             uint8_t j = i + gap;
 
-            if (entity[i].distance < entity[j].distance) {
-                swap(entity[i], entity[j]);
+            if (game.entity[i].distance < game.entity[j].distance) {
+                swap(game.entity[i], game.entity[j]);
                 swapped = true;
             }
         }
     }
 }
 
-// Traduce las coordenadas de una entidad al espacio de visión del jugador
-Coords translateIntoView(Coords *pos) {
-    double sprite_x = pos->x - player.pos.x;
-    double sprite_y = pos->y - player.pos.y;
+// Cámara del cuadro actual a partir de la pose del jugador
+Camera getCamera() {
+    Camera camera;
+    camera.pos = game.player.pos;
+    camera.dir = game.player.dir;
+    camera.plane = game.player.plane;
+    camera.inv_det = 1.0 / (camera.plane.x * camera.dir.y - camera.dir.x * camera.plane.y);
+    return camera;
+}
+
+// Traduce las coordenadas de una entidad al espacio de visión de la cámara
+Coords translateIntoView(Camera *camera, Coords *pos) {
+    double sprite_x = pos->x - camera->pos.x;
+    double sprite_y = pos->y - camera->pos.y;
 
-    double inv_det = 1.0 / (player.plane.x * player.dir.y - player.dir.x * player.plane.y);
-    double transform_x = inv_det * (player.dir.y * sprite_x - player.dir.x * sprite_y);
-    double transform_y = inv_det * (-player.plane.y * sprite_x + player.plane.x * sprite_y);
+    double transform_x = camera->inv_det * (camera->dir.y * sprite_x - camera->dir.x * sprite_y);
+    double transform_y = camera->inv_det * (-camera->plane.y * sprite_x + camera->plane.x * sprite_y);
 
     return {transform_x, transform_y};
 }
 
-// Renderiza todas las entidades en pantalla
-void renderEntities(double view_height) {
+// Ordena las entidades y guarda su posición en el espacio de visión. renderEntities() la usa en cada
+// cuadro y updateGame() la renueva antes de fire(), porque entre dos cuadros puede haber varios pasos
+void updateViewCache() {
     sortEntities();
+    Camera camera = getCamera();
 
-    for (uint8_t i = 0; i < num_entities; i++) {
-        if (entity[i].state == S_HIDDEN) continue;
+    for (uint8_t i = 0; i < game.num_entities; i++) {
+        Coords transform = translateIntoView(&camera, &(game.entity[i].pos));
+        EntityView *view = &game.view[i];
 
-        Coords transform = translateIntoView(&(entity[i].pos));
+        if (transform.y > 0.1) {
+            double scale = 1.0 / transform.y;
+            view->screen_x = HALF_WIDTH * (1.0 + transform.x * scale);
+            view->depth = min(transform.y, 63.99) * (1 << VIEW_DEPTH_SHIFT) + 0.5;
+            view->scale = scale * (1 << VIEW_SCALE_SHIFT) + 0.5;
+        } else {
+            view->depth = 0;
+        }
+    }
+}
+
+// Renderiza todas las entidades en pantalla con la caché de updateViewCache(). Las entidades están
+// ordenadas de lejos a cerca; se colocan de cerca a lejos y drawSprites() las pinta en ese orden
+void renderEntities(double view_height) {
+    static ScreenSprite<RenderDefault> sprites[MAX_ENTITIES]; // Fuera de la pila
+    uint8_t count = 0;
+
+    for (uint8_t i = game.num_entities; i-- > 0;) {
+        if (game.entity[i].state == S_HIDDEN) continue;
 
-        if (transform.y <= 0.1 || transform.y > MAX_SPRITE_DEPTH) continue;
+        EntityView *view = &game.view[i];
 
-        int16_t sprite_screen_x = HALF_WIDTH * (1.0 + transform.x / transform.y);
-        int8_t sprite_screen_y = RENDER_HEIGHT / 2 + view_height / transform.y;
-        uint8_t type = uid_get_type(entity[i].uid);
+        if (!view->depth || view->depth > (uint16_t) MAX_SPRITE_DEPTH << VIEW_DEPTH_SHIFT) continue;
+
+        double scale = (double) view->scale / (1 << VIEW_SCALE_SHIFT);
+        int16_t sprite_screen_x = view->screen_x;
+        int8_t sprite_screen_y = RENDER_HEIGHT / 2 + view_height * scale;
+        uint8_t type = uid_get_type(game.entity[i].uid);
 
         if (sprite_screen_x < -HALF_WIDTH || sprite_screen_x > SCREEN_WIDTH + HALF_WIDTH) continue;
 
         switch (type) {
             case E_ENEMY: {
                 uint8_t sprite;
-                if (entity[i].state == S_ALERT) {
+                if (game.entity[i].state == S_ALERT) {
                     sprite = int(millis() / 500) % 2;
-                } else if (entity[i].state == S_FIRING) {
+                } else if (game.entity[i].state == S_FIRING) {
                     sprite = 2;
-                } else if (entity[i].state == S_HIT) {
+                } else if (game.entity[i].state == S_HIT) {
                     sprite = 3;
-                } else if (entity[i].state == S_MELEE) {
-                    sprite = entity[i].timer > 10 ? 2 : 1;
-                } else if (entity[i].state == S_DEAD) {
-                    sprite = entity[i].timer > 0 ? 3 : 4;
+                } else if (game.entity[i].state == S_MELEE) {
+                    sprite = game.entity[i].timer > 10 ? 2 : 1;
+                } else if (game.entity[i].state == S_DEAD) {
+                    sprite = game.entity[i].timer > 0 ? 3 : 4;
                 } else {
                     sprite = 0;
                 }
 
-                drawSprite(
-                    sprite_screen_x - BMP_IMP_WIDTH * .5 / transform.y,
-                    sprite_screen_y - 8 / transform.y,
-                    bmp_imp_bits,
-                    bmp_imp_mask,
+                if (placeSprite(
+                    &sprites[count],
+                    sprite_screen_x - BMP_IMP_WIDTH * .5 * scale,
+                    sprite_screen_y - 8 * scale,
+                    bmp_imp_spans,
+                    bmp_imp_frames,
                     BMP_IMP_WIDTH,
                     BMP_IMP_HEIGHT,
                     sprite,
-                    transform.y
-                );
+                    view->depth
+                )) count++;
                 break;
             }
             case E_FIREBALL: {
-                drawSprite(
-                    sprite_screen_x - BMP_FIREBALL_WIDTH / 2 / transform.y,
-                    sprite_screen_y - BMP_FIREBALL_HEIGHT / 2 / transform.y,
-                    bmp_fireball_bits,
-                    bmp_fireball_mask,
+                if (placeSprite(
+                    &sprites[count],
+                    sprite_screen_x - BMP_FIREBALL_WIDTH / 2 * scale,
+                    sprite_screen_y - BMP_FIREBALL_HEIGHT / 2 * scale,
+                    bmp_fireball_spans,
+                    bmp_fireball_frames,
                     BMP_FIREBALL_WIDTH,
                     BMP_FIREBALL_HEIGHT,
                     0,
-                    transform.y
-                );
+                    view->depth
+                )) count++;
                 break;
             }
             case E_MEDIKIT: {
-                drawSprite(
-                    sprite_screen_x - BMP_ITEMS_WIDTH / 2 / transform.y,
-                    sprite_screen_y + 5 / transform.y,
-                    bmp_items_bits,
-                    bmp_items_mask,
+                if (placeSprite(
+                    &sprites[count],
+                    sprite_screen_x - BMP_ITEMS_WIDTH / 2 * scale,
+                    sprite_screen_y + 5 * scale,
+                    bmp_items_spans,
+                    bmp_items_frames,
                     BMP_ITEMS_WIDTH,
                     BMP_ITEMS_HEIGHT,
                     0,
-                    transform.y
-                );
+                    view->depth
+                )) count++;
                 break;
             }
             case E_KEY: {
-                drawSprite(
-                    sprite_screen_x - BMP_ITEMS_WIDTH / 2 / transform.y,
-                    sprite_screen_y + 5 / transform.y,
-                    bmp_items_bits,
-                    bmp_items_mask,
+                if (placeSprite(
+                    &sprites[count],
+                    sprite_screen_x - BMP_ITEMS_WIDTH / 2 * scale,
+                    sprite_screen_y + 5 * scale,
+                    bmp_items_spans,
+                    bmp_items_frames,
                     BMP_ITEMS_WIDTH,
                     BMP_ITEMS_HEIGHT,
                     1,
-                    transform.y
-                );
+                    view->depth
+                )) count++;
                 break;
             }
         }
     }
+
+    drawSprites(sprites, count);
 }
 
-// Renderiza el arma en la pantalla
+// Renderiza el arma en la pantalla, centrada sobre el borde inferior de la zona de renderizado
+template <class Config>
 void renderGun(uint8_t gun_pos, double amount_jogging) {
-    char x = 48 + sin((double)millis() * JOGGING_SPEED) * 10 * amount_jogging;
-    char y = RENDER_HEIGHT - gun_pos + abs(cos((double)millis() * JOGGING_SPEED)) * 8 * amount_jogging;
+    typename Config::coord x = (Config::width - BMP_GUN_WIDTH) / 2 + sin((double)millis() * JOGGING_SPEED) * 10 * amount_jogging;
+    typename Config::coord y = Config::render_height - gun_pos + abs(cos((double)millis() * JOGGING_SPEED)) * 8 * amount_jogging;
 
     if (gun_pos > GUN_SHOT_POS - 2) {
-        display.drawBitmap(x + 6, y - 11, bmp_fire_bits, BMP_FIRE_WIDTH, BMP_FIRE_HEIGHT, 1);
+        drawOverlay<Config>(x + 6, y - 11, bmp_fire_bits, NULL, BMP_FIRE_WIDTH, BMP_FIRE_HEIGHT, Config::height);
     }
 
-    uint8_t clip_height = max(0, min(y + BMP_GUN_HEIGHT, RENDER_HEIGHT) - y);
-
-    display.drawBitmap(x, y, bmp_gun_mask, BMP_GUN_WIDTH, clip_height, 0);
-    display.drawBitmap(x, y, bmp_gun_bits, BMP_GUN_WIDTH, clip_height, 1);
+    // Máscara y arma en una sola pasada, recortadas a la zona de renderizado
+    drawOverlay<Config>(x, y, bmp_gun_bits, bmp_gun_mask, BMP_GUN_WIDTH, BMP_GUN_HEIGHT, Config::render_height);
 }
-// Renderiza el HUD (Head-Up Display) en la pantalla
+// Renderiza el HUD (Head-Up Display) en la última línea de texto de la imagen
+template <class Config>
 void renderHud() {
-    drawText(2, 58, F("{}"), 0);         // Muestra la salud del jugador
-    drawText(40, 58, F("[]"), 0);        // Muestra el número de llaves
-    updateHud();                         // Actualiza el HUD con los valores actuales
+    drawText<Config>(2, Config::height - 6, F("{}"), 0);  // Muestra la salud del jugador
+    drawText<Config>(40, Config::height - 6, F("[]"), 0); // Muestra el número de llaves
+    updateHud<Config>();                 // Actualiza el HUD con los valores actuales
 }
 
 // Actualiza la información mostrada en el HUD
+template <class Config>
 void updateHud() {
-    display.clearRect(12, 58, 15, 6);    // Limpia el área de la salud
-    display.clearRect(50, 58, 5, 6);     // Limpia el área de las llaves
+#ifdef HOST_BUILD
+    if (host_headless) return;
+#endif
+    clearRect<Config>(12, Config::height - 6, 15, 6); // Limpia el área de la salud
+    clearRect<Config>(50, Config::height - 6, 5, 6);  // Limpia el área de las llaves
 
-    drawText(12, 58, player.health);     // Dibuja la salud del jugador
-    drawText(50, 58, player.keys);       // Dibuja la cantidad de llaves del jugador
+    drawText<Config>(12, Config::height - 6, game.player.health); // Dibuja la salud del jugador
+    drawText<Config>(50, Config::height - 6, game.player.keys);   // Dibuja la cantidad de llaves del jugador
 }
 
-// Renderiza las estadísticas adicionales en pantalla (FPS y número de entidades)
+// Renderiza las estadísticas adicionales en pantalla (FPS y número de entidades), alineadas a la derecha
+template <class Config>
 void renderStats() {
-    display.clearRect(58, 58, 70, 6);    // Limpia el área de estadísticas
-    drawText(114, 58, int(getActualFps())); // Muestra los FPS actuales
-    drawText(82, 58, num_entities);      // Muestra el número de entidades activas
+    clearRect<Config>(Config::width - 70, Config::height - 6, 70, 6); // Limpia el área de estadísticas
+    drawText<Config>(Config::width - 14, Config::height - 6, int(getActualFps())); // Muestra los FPS actuales
+    drawText<Config>(Config::width - 46, Config::height - 6, game.num_entities);   // Muestra el número de entidades activas
 }
 
 // Lógica del bucle para la escena de introducción
@@ -620,104 +1419,131 @@ void loopIntro() {
     };
 }
 
-// Lógica del bucle para la escena de juego
-void loopGamePlay() {
-    bool gun_fired = false;          // Estado del disparo
-    bool walkSoundToggle = false;    // Alterna entre sonidos de caminar
-    uint8_t gun_pos = 0;             // Posición del arma
+// Avanza la partida un paso de simulación (FRAME_TIME) con los botones de input (máscara de BUTTONS)
+void updateGame(const uint8_t level[], uint16_t input) {
     double rot_speed;                // Velocidad de rotación
     double old_dir_x;                // Dirección anterior en X
     double old_plane_x;              // Dirección del plano anterior
-    double view_height;              // Altura de la vista
-    double jogging;                  // Intensidad del movimiento
-    uint8_t fade = GRADIENT_COUNT - 1; // Gradiente de desvanecimiento
 
-    initializeLevel(sto_level_1);    // Inicializa el primer nivel
-
-    do {
-        fps();                       // Calcula los FPS actuales
+    if (game.player.health > 0) {
+        if (input & UP) {
+            game.player.velocity += (MOV_SPEED - game.player.velocity) * .4; // Aumenta la velocidad hacia adelante
+            game.jogging = abs(game.player.velocity) * MOV_SPEED_INV;         // Calcula el movimiento
+        } else if (input & DOWN) {
+            game.player.velocity += (-MOV_SPEED - game.player.velocity) * .4; // Aumenta la velocidad hacia atrás
+            game.jogging = abs(game.player.velocity) * MOV_SPEED_INV;
+        } else {
+            game.player.velocity *= .5;         // Reduce la velocidad gradualmente
+            game.jogging = abs(game.player.velocity) * MOV_SPEED_INV;
+        }
 
-        memset(display_buf, 0, SCREEN_WIDTH * (RENDER_HEIGHT / 8)); // Limpia el búfer de la pantalla
+        if (input & RIGHT) {
+            rot_speed = ROT_SPEED; // Calcula la rotación
+            old_dir_x = game.player.dir.x;
+            game.player.dir.x = game.player.dir.x * cos(-rot_speed) - game.player.dir.y * sin(-rot_speed);
+            game.player.dir.y = old_dir_x * sin(-rot_speed) + game.player.dir.y * cos(-rot_speed);
+            old_plane_x = game.player.plane.x;
+            game.player.plane.x = game.player.plane.x * cos(-rot_speed) - game.player.plane.y * sin(-rot_speed);
+            game.player.plane.y = old_plane_x * sin(-rot_speed) + game.player.plane.y * cos(-rot_speed);
+        } else if (input & LEFT) {
+            rot_speed = ROT_SPEED;
+            old_dir_x = game.player.dir.x;
+            game.player.dir.x = game.player.dir.x * cos(rot_speed) - game.player.dir.y * sin(rot_speed);
+            game.player.dir.y = old_dir_x * sin(rot_speed) + game.player.dir.y * cos(rot_speed);
+            old_plane_x = game.player.plane.x;
+            game.player.plane.x = game.player.plane.x * cos(rot_speed) - game.player.plane.y * sin(rot_speed);
+            game.player.plane.y = old_plane_x * sin(rot_speed) + game.player.plane.y * cos(rot_speed);
+        }
 
-#ifdef SNES_CONTROLLER
-        getControllerData();         // Obtiene datos del controlador si está habilitado
-#endif
+        game.view_height = abs(sin((double)millis() * JOGGING_SPEED)) * 6 * game.jogging; // Ajusta la altura de la vista
 
-        if (player.health > 0) {
-            if (input_up()) {
-                player.velocity += (MOV_SPEED - player.velocity) * .4; // Aumenta la velocidad hacia adelante
-                jogging = abs(player.velocity) * MOV_SPEED_INV;       // Calcula el movimiento
-            } else if (input_down()) {
-                player.velocity += (-MOV_SPEED - player.velocity) * .4; // Aumenta la velocidad hacia atrás
-                jogging = abs(player.velocity) * MOV_SPEED_INV;
+        if (game.view_height > 5.9) {
+            if (!game.walk_sound_toggle) {
+                playSound(walk1_snd);
+                game.walk_sound_toggle = true;
             } else {
-                player.velocity *= .5;         // Reduce la velocidad gradualmente
-                jogging = abs(player.velocity) * MOV_SPEED_INV;
+                playSound(walk2_snd);
+                game.walk_sound_toggle = false;
             }
+        }
 
-            if (input_right()) {
-                rot_speed = ROT_SPEED * delta; // Calcula la rotación
-                old_dir_x = player.dir.x;
-                player.dir.x = player.dir.x * cos(-rot_speed) - player.dir.y * sin(-rot_speed);
-                player.dir.y = old_dir_x * sin(-rot_speed) + player.dir.y * cos(-rot_speed);
-                old_plane_x = player.plane.x;
-                player.plane.x = player.plane.x * cos(-rot_speed) - player.plane.y * sin(-rot_speed);
-                player.plane.y = old_plane_x * sin(-rot_speed) + player.plane.y * cos(-rot_speed);
-            } else if (input_left()) {
-                rot_speed = ROT_SPEED * delta;
-                old_dir_x = player.dir.x;
-                player.dir.x = player.dir.x * cos(rot_speed) - player.dir.y * sin(rot_speed);
-                player.dir.y = old_dir_x * sin(rot_speed) + player.dir.y * cos(rot_speed);
-                old_plane_x = player.plane.x;
-                player.plane.x = player.plane.x * cos(rot_speed) - player.plane.y * sin(rot_speed);
-                player.plane.y = old_plane_x * sin(rot_speed) + player.plane.y * cos(rot_speed);
-            }
+        if (game.gun_pos > GUN_TARGET_POS) {
+            game.gun_pos -= 1; // Retroceso del arma
+        } else if (game.gun_pos < GUN_TARGET_POS) {
+            game.gun_pos += 2;
+        } else if (!game.gun_fired && (input & Y)) {
+            game.gun_pos = GUN_SHOT_POS; // Disparo del arma
+            game.gun_fired = true;
+            updateViewCache(); // Apunta con la pose de este paso, no con la del último cuadro dibujado
+            fire();
+        } else if (game.gun_fired && !(input & Y)) {
+            game.gun_fired = false; // Estado de no disparo
+        }
+    } else {
+        if (game.view_height > -10) game.view_height--; // Ajusta la vista al morir
+        else if (input & Y) jumpTo(INTRO); // Reinicia al intro
 
-            view_height = abs(sin((double)millis() * JOGGING_SPEED)) * 6 * jogging; // Ajusta la altura de la vista
+        if (game.gun_pos > 1) game.gun_pos -= 2;
+    }
 
-            if (view_height > 5.9) {
-                if (!walkSoundToggle) {
-                    playSound(walk1_snd, WALK1_SND_LEN);
-                    walkSoundToggle = true;
-                } else {
-                    playSound(walk2_snd, WALK2_SND_LEN);
-                    walkSoundToggle = false;
-                }
-            }
+    if (abs(game.player.velocity) > 0.003) {
+        updatePosition(
+            level,
+            &(game.player.pos),
+            game.player.dir.x * game.player.velocity,
+            game.player.dir.y * game.player.velocity
+        );
+    } else {
+        game.player.velocity = 0;
+    }
 
-            if (gun_pos > GUN_TARGET_POS) {
-                gun_pos -= 1; // Retroceso del arma
-            } else if (gun_pos < GUN_TARGET_POS) {
-                gun_pos += 2;
-            } else if (!gun_fired && input_fire()) {
-                gun_pos = GUN_SHOT_POS; // Disparo del arma
-                gun_fired = true;
-                fire();
-            } else if (gun_fired && !input_fire()) {
-                gun_fired = false; // Estado de no disparo
-            }
-        } else {
-            if (view_height > -10) view_height--; // Ajusta la vista al morir
-            else if (input_fire()) jumpTo(INTRO); // Reinicia al intro
+    updateEntities(level);           // Actualiza las entidades
+    updateDoors();                   // Abre y cierra las puertas
+    profileStage(PROFILE_UPDATE);
+    updateFlowField(level);          // Avanza el campo de flujo de los enemigos
+    profileStage(PROFILE_FLOW);
+}
 
-            if (gun_pos > 1) gun_pos -= 2;
-        }
+// Dibuja la vista de la partida: mapa, entidades y arma
+void renderGame() {
+#ifdef HOST_BUILD
+    renderMapThreaded<RenderDefault>(sto_level_1, game.view_height); // Renderiza el mapa
+#else
+    renderMap<RenderDefault>(sto_level_1, game.view_height); // Renderiza el mapa
+#endif
+    profileStage(PROFILE_MAP);
+    updateViewCache();           // Entidades en el espacio de visión del cuadro
+    renderEntities(game.view_height); // Renderiza las entidades
+    renderGun(game.gun_pos, game.jogging); // Renderiza el arma
+    profileStage(PROFILE_ENTITIES);
+}
 
-        if (abs(player.velocity) > 0.003) {
-            updatePosition(
-                sto_level_1,
-                &(player.pos),
-                player.dir.x * player.velocity * delta,
-                player.dir.y * player.velocity * delta
-            );
-        } else {
-            player.velocity = 0;
+// Lógica del bucle para la escena de juego
+void loopGamePlay() {
+    uint8_t fade = GRADIENT_COUNT - 1; // Gradiente de desvanecimiento
+
+    initializeLevel<Level1>();    // Inicializa el primer nivel
+    startTicks();
+
+    do {
+        uint8_t ticks = fps();       // Pasos de simulación pendientes
+        profileBegin();
+
+#ifndef FLOOR_CEILING
+        memset(display_buf, 0, SCREEN_WIDTH * (RENDER_HEIGHT / 8)); // Limpia el búfer de la pantalla
+#endif
+
+#ifdef SNES_CONTROLLER
+        getControllerData();         // Obtiene datos del controlador si está habilitado
+#endif
+        uint16_t input = input_read();
+
+        // Lógica a paso fijo: avanza igual aunque el dibujado se retrase
+        for (; ticks > 0; ticks--) {
+            updateGame(sto_level_1, input);
         }
 
-        updateEntities(sto_level_1);      // Actualiza las entidades
-        renderMap(sto_level_1, view_height); // Renderiza el mapa
-        renderEntities(view_height);      // Renderiza las entidades
-        renderGun(gun_pos, jogging);      // Renderiza el arma
+        renderGame();
 
         if (fade > 0) {
             fadeScreen(fade);             // Realiza el efecto de desvanecimiento
@@ -730,15 +1556,17 @@ void loopGamePlay() {
             renderStats();                // Muestra estadísticas en pantalla
         }
 
-        if (flash_screen > 0) {
+        if (game.flash_screen > 0) {
             invert_screen = !invert_screen; // Invierte la pantalla temporalmente
-            flash_screen--;
+            game.flash_screen--;
         } else if (invert_screen) {
             invert_screen = 0;            // Vuelve a la normalidad
         }
 
         display.invertDisplay(invert_screen);
         display.display();
+        profileStage(PROFILE_DISPLAY);
+        profileReport();
 
 #ifdef SNES_CONTROLLER
         if (input_start()) {
@@ -750,6 +1578,96 @@ void loopGamePlay() {
     } while (!exit_scene);
 }
 
+#ifdef RUN_RENDER_CHECK
+// Renderiza la pose i de render_check.h en el búfer de pantalla, partiendo de un nivel sin entidades
+// activas. También lo usa host/render_check.cpp para comparar con las imágenes de referencia
+void renderCheckPose(uint8_t i) {
+    RenderCheckPose pose;
+    memcpy_P(&pose, render_check_poses + i, sizeof(RenderCheckPose));
+
+    initializeLevel<Level1>();
+    game.player.pos = create_coords(pose.x * .5, pose.y * .5);
+    game.player.dir = create_coords(
+        (int8_t) pgm_read_byte(&render_check_headings[pose.heading][0]) / 64.0,
+        (int8_t) pgm_read_byte(&render_check_headings[pose.heading][1]) / 64.0
+    );
+    game.player.plane = create_coords(game.player.dir.y * .66, -game.player.dir.x * .66);
+    game.num_entities = 0;
+
+    memset(display.getBuffer(), 0, SCREEN_WIDTH * (SCREEN_HEIGHT / 8));
+    memset(zbuffer, 0xFF, ZBUFFER_SIZE); // Las columnas sin impacto conservan el valor anterior
+    renderMap<RenderDefault>(sto_level_1, 0);
+    updateViewCache();
+    renderEntities(0);
+    renderGun(GUN_TARGET_POS, 0);
+    renderHud();
+}
+
+// Lógica de la escena de verificación: renderiza cada pose fija y compara su hash con el de la
+// configuración actual. Los cuadros distintos se envían como PBM para compararlos en el ordenador
+void loopRenderCheck() {
+    uint8_t failures = 0;
+
+    Serial.begin(115200);
+    Serial.println(F("RENDER_CHECK"));
+
+    for (uint8_t i = 0; i < RENDER_CHECK_POSES; i++) {
+        renderCheckPose(i);
+        uint32_t hash = getFrameHash();
+
+#ifdef RENDER_CHECK_RECORD
+        Serial.print(F("  0x"));
+        Serial.print(hash, HEX);
+        Serial.println(',');
+#else
+#ifdef RENDER_CHECK_HASHES
+        if (hash == pgm_read_dword(render_check_hashes + i)) continue;
+        Serial.print(F("FALLO pose "));
+#else
+        Serial.print(F("SIN REFERENCIA pose "));
+#endif
+        Serial.print(i);
+        Serial.print(F(" hash 0x"));
+        Serial.println(hash, HEX);
+
+        // Imagen del cuadro para compararla con la referencia con host/render_check -c
+        dumpFrame();
+        failures++;
+#endif
+    }
+
+    Serial.print(F("FALLOS "));
+    Serial.println(failures);
+    display.display();
+    jumpTo(INTRO);
+}
+#endif
+
+#ifdef BENCH_SIMAVR
+// Lógica de la escena de medición: juega BENCH_FRAMES cuadros del recorrido de bench.h, un paso por
+// cuadro y sin esperar al reloj, con las etapas marcadas en GPIOR0 para host/simavr_bench.c
+void loopBench() {
+    initializeLevel<Level1>();
+    renderHud();
+
+    for (uint16_t frame = 0; frame < BENCH_FRAMES; frame++) {
+        profileBegin();
+
+#ifndef FLOOR_CEILING
+        memset(display_buf, 0, SCREEN_WIDTH * (RENDER_HEIGHT / 8)); // Limpia el búfer de la pantalla
+#endif
+        updateGame(sto_level_1, getBenchInput(frame));
+        renderGame();
+        renderStats();
+        display.display();
+        profileStage(PROFILE_DISPLAY);
+    }
+
+    profileEnd();
+    jumpTo(INTRO);
+}
+#endif
+
 // Bucle principal del programa
 void loop(void) {
     switch (scene) {
@@ -761,10 +1679,22 @@ void loop(void) {
             loopGamePlay(); // Escena de juego
             break;
         }
+#ifdef RUN_RENDER_CHECK
+        case RENDER_CHECK: {
+            loopRenderCheck(); // Escena de verificación del renderizado
+            break;
+        }
+#endif
+#ifdef BENCH_SIMAVR
+        case BENCH: {
+            loopBench(); // Escena de medición en simavr
+            break;
+        }
+#endif
     }
 
     for (uint8_t i = 0; i < GRADIENT_COUNT; i++) {
-        fadeScreen(i, 0); // Realiza el efecto de desvanecimiento
+        transitionScreen(SCENE_TRANSITION, i, 0); // Realiza la transición entre escenas
         display.display();
         delay(40);
     }
@@ -16,7 +16,7 @@
 Entity create_entity(uint8_t type, uint8_t x, uint8_t y, uint8_t initialState, uint8_t initialHealth) {
     UID uid = create_uid(type, x, y); // Crea un UID único para la entidad
     Coords pos = create_coords((double)x + .5, (double)y + .5); // Calcula las coordenadas iniciales
-    Entity new_entity = { uid, pos, initialState, initialHealth, 0, 0 }; // Inicializa la entidad
+    Entity new_entity = { uid, pos, initialState, initialHealth, 0, 0, false, 0 }; // Inicializa la entidad
     return new_entity;
 }
 
@@ -27,8 +27,9 @@ Entity create_entity(uint8_t type, uint8_t x, uint8_t y, uint8_t initialState, u
  * @param x Coordenada X en el nivel.
  * @param y Coordenada Y en el nivel.
  * @param active Indica si la entidad está activa o inactiva.
+ * @param initialState Estado inicial de la entidad.
  * @return Una nueva instancia de `StaticEntity` inicializada con los valores dados.
  */
-StaticEntity crate_static_entity(UID uid, uint8_t x, uint8_t y, bool active) {
-    return { uid, x, y, active }; // Inicializa y retorna la entidad estática
+StaticEntity create_static_entity(UID uid, uint8_t x, uint8_t y, bool active, uint8_t initialState) {
+    return { uid, x, y, active, initialState, 0 }; // Inicializa y retorna la entidad estática
 }
@@ -32,6 +32,9 @@
 // Crea un proyectil (bola de fuego) con dirección inicial.
 #define create_fireball(x, y, dir)    create_entity(E_FIREBALL, x, y, S_STAND, dir)
 
+// Crea una puerta (E_DOOR o E_LOCKEDDOOR) cerrada.
+#define create_door(type, x, y)       create_static_entity(create_uid(type, x, y), x, y, true, S_CLOSE)
+
 // ------------------------------------
 // Estados de las entidades
 // ------------------------------------
@@ -67,6 +70,8 @@ struct Entity {
   uint8_t health;    // Salud de la entidad (ángulo en el caso de proyectiles)
   uint8_t distance;  // Distancia al jugador (usado para ordenamiento)
   uint8_t timer;     // Temporizador para cambios de estado
+  bool sight;        // Línea de visión con el jugador (se actualiza de forma escalonada)
+  uint8_t ai_owed;   // Pasos de IA pendientes de aplicar (enemigos lejanos actualizados por turnos)
 };
 
 // Estructura de una entidad estática
@@ -75,6 +80,8 @@ struct StaticEntity {
   uint8_t x;         // Coordenada X
   uint8_t y;         // Coordenada Y
   bool active;       // Indica si la entidad está activa o no
+  uint8_t state;     // Estado actual (S_OPEN / S_CLOSE en las puertas)
+  uint8_t offset;    // Apertura de la puerta, de 0 (cerrada) a 255 (abierta)
 };
 
 // ------------------------------------
@@ -85,6 +92,6 @@ struct StaticEntity {
 Entity create_entity(uint8_t type, uint8_t x, uint8_t y, uint8_t initialState, uint8_t initialHealth);
 
 // Crea una entidad estática en el juego.
-StaticEntity create_static_entity(UID uid, uint8_t x, uint8_t y, bool active);
+StaticEntity create_static_entity(UID uid, uint8_t x, uint8_t y, bool active, uint8_t initialState);
 
 #endif
@@ -0,0 +1,107 @@
+#ifndef _host_arduino_h
+#define _host_arduino_h
+
+/*
+  Sustituto mínimo del núcleo de Arduino para compilar el juego en el ordenador (HOST_BUILD).
+
+  Solo cubre lo que usa el sketch: PROGMEM se lee como memoria normal, los registros de los
+  temporizadores son variables, los pines de entrada se leen de host_pins y Serial escribe en la
+  salida estándar. millis() y micros() siguen el reloj del sistema salvo que host_manual_clock
+  esté activo; entonces devuelven host_clock_us, que avanza quien ejecuta la simulación. Cada hilo
+  tiene su propio host_clock_us, así que las simulaciones en paralelo no comparten reloj.
+  host_headless desactiva el sonido y el HUD para simular partidas sin pantalla.
+*/
+
+// Las cabeceras estándar van antes de las macros min, max y abs de Arduino
+#include <chrono>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "avr/pgmspace.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define min(a, b)             ((a) < (b) ? (a) : (b))
+#define max(a, b)             ((a) > (b) ? (a) : (b))
+#define abs(x)                ((x) > 0 ? (x) : -(x))
+#define constrain(x, lo, hi)  ((x) < (lo) ? (lo) : ((x) > (hi) ? (hi) : (x)))
+#define bitRead(value, bit)   (((value) >> (bit)) & 0x01)
+#define _BV(bit)              (1 << (bit))
+
+#define PI                    3.1415926535897932384626433832795
+#define F_CPU                 16000000UL
+
+#define HIGH                  1
+#define LOW                   0
+#define INPUT                 0
+#define OUTPUT                1
+#define INPUT_PULLUP          2
+#define DEC                   10
+#define HEX                   16
+
+class __FlashStringHelper;
+#define F(s)                  (reinterpret_cast<const __FlashStringHelper *>(s))
+
+// Reloj
+extern bool host_manual_clock;
+extern thread_local uint64_t host_clock_us;
+
+// Simulación sin pantalla ni sonido
+extern bool host_headless;
+
+inline unsigned long micros() {
+  if (host_manual_clock) return host_clock_us;
+  static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+inline unsigned long millis() { return micros() / 1000; }
+inline void delay(unsigned long) {}
+inline void delayMicroseconds(unsigned int) {}
+
+// Pines
+extern uint8_t host_pins[32];
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t pin, uint8_t value) { host_pins[pin] = value; }
+inline int digitalRead(uint8_t pin) { return host_pins[pin]; }
+
+// Temporizadores e interrupciones del sonido
+extern volatile uint8_t TCCR1A, TCCR1B, TCCR1C, TCCR2A, TCCR2B, OCR2A, TIMSK2, GPIOR0;
+extern volatile uint16_t OCR1A;
+#define WGM12                 3
+#define WGM21                 1
+#define CS20                  0
+#define CS21                  1
+#define CS22                  2
+#define OCIE2A                1
+#define COM1A0                6
+#define COM1B0                4
+#define FOC1A                 7
+#define ISR(vector)           void vector()
+inline void cli() {}
+inline void sei() {}
+
+// Serial
+class HostSerial {
+  public:
+    void begin(unsigned long) {}
+    void print(const char *s) { fputs(s, stdout); }
+    void print(const __FlashStringHelper *s) { fputs(reinterpret_cast<const char *>(s), stdout); }
+    void print(char c) { putchar(c); }
+    void print(double v) { printf("%.2f", v); }
+    void print(unsigned long v, int base = DEC) { printf(base == HEX ? "%lX" : "%lu", v); }
+    void print(long v, int base = DEC) { printf(base == HEX ? "%lX" : "%ld", v); }
+    void print(unsigned int v, int base = DEC) { print((unsigned long) v, base); }
+    void print(int v, int base = DEC) { print((long) v, base); }
+    void print(unsigned char v, int base = DEC) { print((unsigned long) v, base); }
+    template <class T> void println(T v) { print(v); putchar('\n'); }
+    template <class T> void println(T v, int base) { print(v, base); putchar('\n'); }
+    void println() { putchar('\n'); }
+};
+
+extern HostSerial Serial;
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef _host_ssd1306_h
+#define _host_ssd1306_h
+
+// Pantalla del ordenador: el mismo búfer por páginas que la biblioteca, sin enviarlo a ningún sitio
+#include <Arduino.h>
+
+#define SSD1306_SWITCHCAPVCC  2
+
+template <uint8_t WIDTH, uint8_t HEIGHT>
+class Adafruit_SSD1306 {
+  public:
+    bool begin(uint8_t, uint8_t) { return true; }
+    uint8_t *getBuffer() { return buffer; }
+    void display() {}
+    void clearDisplay() { memset(buffer, 0, sizeof(buffer)); }
+    void invertDisplay(bool) {}
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) {
+      if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) return;
+      if (color) buffer[x + (y / 8) * WIDTH] |= 1 << (y & 7);
+      else buffer[x + (y / 8) * WIDTH] &= ~(1 << (y & 7));
+    }
+
+    void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color) {
+      int16_t byte_width = (w + 7) / 8;
+      for (int16_t j = 0; j < h; j++) {
+        for (int16_t i = 0; i < w; i++) {
+          if (bitmap[j * byte_width + i / 8] & (128 >> (i & 7))) drawPixel(x + i, y + j, color);
+        }
+      }
+    }
+
+    void clearRect(int16_t x, int16_t y, int16_t w, int16_t h) {
+      for (int16_t j = 0; j < h; j++) {
+        for (int16_t i = 0; i < w; i++) drawPixel(x + i, y + j, 0);
+      }
+    }
+
+  private:
+    uint8_t buffer[WIDTH * HEIGHT / 8];
+};
+
+#endif
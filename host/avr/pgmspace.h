@@ -0,0 +1,14 @@
+#ifndef _host_pgmspace_h
+#define _host_pgmspace_h
+
+// En el ordenador la memoria de programa es memoria normal
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P                 const char *
+#define pgm_read_byte(addr)   (*(const uint8_t *)(addr))
+#define pgm_read_word(addr)   (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr)  (*(const uint32_t *)(addr))
+#define memcpy_P              memcpy
+
+#endif
@@ -0,0 +1,10 @@
+// Variables del sustituto de Arduino (Arduino.h) para HOST_BUILD
+#include <Arduino.h>
+
+bool host_manual_clock = false;
+thread_local uint64_t host_clock_us = 0;
+bool host_headless = false;
+uint8_t host_pins[32];
+volatile uint8_t TCCR1A, TCCR1B, TCCR1C, TCCR2A, TCCR2B, OCR2A, TIMSK2, GPIOR0;
+volatile uint16_t OCR1A;
+HostSerial Serial;
@@ -0,0 +1,127 @@
+/*
+  Banco de pruebas del raycaster en el ordenador (HOST_BUILD).
+
+  Renderiza el mapa de sto_level_1 con la cámara girando sobre la posición inicial en varias
+  geometrías de imagen, con renderMap() y con renderMapThreaded(), e imprime el tiempo medio por
+  cuadro y por columna de rayo y la aceleración con 2, 4, 8... hilos hasta el máximo (por defecto,
+  los núcleos del ordenador). Las geometrías distintas de la pantalla dibujan en sus propios
+  búferes (FrameTarget), así que todas conviven en el mismo ejecutable. Con cada número de hilos
+  comprueba además que renderMapThreaded() deja la misma imagen, z-buffer y entidades que
+  renderMap() en CHECK_ANGLES orientaciones, con la partida por defecto y con otra GameState
+  activa en el hilo principal, y termina con error si alguna es distinta.
+
+  Uso: render_bench [cuadros] [hilos máximos]
+*/
+#include "doom_sketch.cpp"
+
+typedef RenderConfig<FrameGeometry<128, 64, 56>, RES_DIVIDER, Z_RES_DIVIDER, MAX_RENDER_DEPTH, DISTANCE_MULTIPLIER, true> Render128x64;
+typedef RenderConfig<FrameGeometry<128, 128, 112>, RES_DIVIDER, Z_RES_DIVIDER, MAX_RENDER_DEPTH, DISTANCE_MULTIPLIER, true> Render128x128;
+typedef RenderConfig<FrameGeometry<256, 64, 56>, RES_DIVIDER, Z_RES_DIVIDER, MAX_RENDER_DEPTH, DISTANCE_MULTIPLIER, true> Render256x64;
+typedef RenderConfig<FrameGeometry<640, 400, 352>, 1, 1, MAX_RENDER_DEPTH, DISTANCE_MULTIPLIER, true> Render640x400;
+
+// Tiempo medio por cuadro (us) de frames cuadros girando la cámara una vuelta completa
+template <class Config, bool Threaded>
+double benchFrames(uint16_t frames) {
+    initializeLevel<Level1>();
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint16_t i = 0; i < frames; i++) {
+        double angle = 2 * PI * i / frames;
+        game.player.dir = create_coords(cos(angle), sin(angle));
+        game.player.plane = create_coords(game.player.dir.y * 0.66, -game.player.dir.x * 0.66);
+
+        if (Threaded) renderMapThreaded<Config>(sto_level_1, 0);
+        else renderMap<Config>(sto_level_1, 0);
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+    return elapsed.count() / frames;
+}
+
+// Orientaciones (de CHECK_ANGLES) en las que renderMapThreaded() no deja la misma imagen, z-buffer y
+// entidades generadas que renderMap() jugando sobre state. Si state no es default_game, la cámara de
+// default_game mira al lado contrario, así que un hilo que dibuje la partida equivocada se nota
+#define CHECK_ANGLES          64
+
+GameState swapped_game; // Partida distinta de default_game para la comprobación
+
+template <class Config>
+uint8_t countMismatches(GameState *state) {
+    typedef FrameTarget<typename Config::geometry> Target;
+    constexpr uint32_t frame_size = Config::width * Config::geometry::pages;
+    constexpr uint16_t depth_size = Config::width / Config::z_res_divider;
+    static uint8_t frame[frame_size];
+    static uint8_t depth[depth_size];
+    UID uids[MAX_ENTITIES];
+    uint8_t num_entities = 0;
+    uint8_t mismatches = 0;
+
+    for (uint8_t i = 0; i < CHECK_ANGLES; i++) {
+        double angle = 2 * PI * i / CHECK_ANGLES;
+        if (state != &default_game) {
+            active_game = &default_game;
+            initializeLevel<Level1>();
+            game.player.dir = create_coords(-cos(angle), -sin(angle));
+            game.player.plane = create_coords(game.player.dir.y * 0.66, -game.player.dir.x * 0.66);
+        }
+        active_game = state;
+
+        for (uint8_t threaded = 0; threaded < 2; threaded++) {
+            initializeLevel<Level1>();
+            game.player.dir = create_coords(cos(angle), sin(angle));
+            game.player.plane = create_coords(game.player.dir.y * 0.66, -game.player.dir.x * 0.66);
+            memset(Target::getFrame(), 0, frame_size);
+            memset(Target::getDepth(), 0xFF, depth_size);
+
+            if (!threaded) {
+                renderMap<Config>(sto_level_1, 0);
+                memcpy(frame, Target::getFrame(), frame_size);
+                memcpy(depth, Target::getDepth(), depth_size);
+                num_entities = game.num_entities;
+                for (uint8_t e = 0; e < num_entities; e++) uids[e] = game.entity[e].uid;
+                continue;
+            }
+
+            renderMapThreaded<Config>(sto_level_1, 0);
+            bool same = memcmp(frame, Target::getFrame(), frame_size) == 0 &&
+                memcmp(depth, Target::getDepth(), depth_size) == 0 && num_entities == game.num_entities;
+            for (uint8_t e = 0; same && e < num_entities; e++) same = uids[e] == game.entity[e].uid;
+            if (!same) mismatches++;
+        }
+    }
+    active_game = &default_game;
+    return mismatches;
+}
+
+uint16_t failures = 0; // Orientaciones distintas entre renderMap() y renderMapThreaded()
+
+template <class Config>
+void bench(uint16_t frames, uint8_t max_threads) {
+    uint16_t rays = Config::width / Config::res_divider;
+    double serial = benchFrames<Config, false>(frames);
+
+    printf("%4ux%-4u %5u rayos  %9.1f us/cuadro  %6.3f us/rayo ", Config::width, Config::height, rays, serial, serial / rays);
+    for (uint8_t threads = 2; threads <= max_threads; threads *= 2) {
+        render_threads = threads;
+        printf(" %2u hilos x%.2f", threads, serial / benchFrames<Config, true>(frames));
+
+        uint8_t mismatches = countMismatches<Config>(&default_game) + countMismatches<Config>(&swapped_game);
+        if (mismatches) printf(" (distinto de renderMap() en %u de %u orientaciones)", mismatches, 2 * CHECK_ANGLES);
+        failures += mismatches;
+    }
+    printf("\n");
+}
+
+int main(int argc, char **argv) {
+    uint16_t frames = argc > 1 ? atoi(argv[1]) : 2000;
+    uint8_t max_threads = argc > 2 ? atoi(argv[2]) : render_threads;
+
+    printf("%u núcleos\n", RenderPool::hardwareThreads());
+
+    setup();
+    bench<Render128x64>(frames, max_threads);
+    bench<Render128x128>(frames, max_threads);
+    bench<Render256x64>(frames, max_threads);
+    bench<Render640x400>(frames, max_threads);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,171 @@
+/*
+  Verificación del renderizado en el ordenador (HOST_BUILD).
+
+  Renderiza las poses de render_check.h con renderCheckPose() y compara cada cuadro byte a byte con
+  su imagen de referencia de host/render_check/<configuración>/: los píxeles distintos se cuentan
+  con XOR y popcount, y un cuadro falla si pasan de la tolerancia (RENDER_CHECK_TOLERANCE o -t).
+  La configuración es el nombre de las opciones que cambian la imagen (textured_walls,
+  floor_ceiling, column_lod, unidas con +) o default; WALL_BITMAP, EMPTY_SPACE_SKIP y COLUMN_CACHE
+  deben dar la misma imagen que sin ellas y se comparan con las mismas referencias.
+
+  Por cada cuadro que no coincide escribe en build/render_check/ el cuadro obtenido (poseN.pbm) y
+  los píxeles distintos (poseN_diff.pbm). Con -r graba las referencias de la configuración actual,
+  y con -c compara una imagen PBM (P1 o P4), por ejemplo la enviada por dumpFrame() en la escena
+  RENDER_CHECK de la placa, con la referencia de una pose.
+
+  Uso: render_check [-t tolerancia] [-r] [-c imagen.pbm pose]
+*/
+#include <string>
+#include <getopt.h>
+#include <sys/stat.h>
+
+#define RUN_RENDER_CHECK
+#include "doom_sketch.cpp"
+
+#define FRAME_BYTES           (SCREEN_WIDTH * (SCREEN_HEIGHT / 8))
+
+// Nombre de la configuración, que es también el directorio de sus referencias
+std::string configName() {
+    std::string name;
+#ifdef TEXTURED_WALLS
+    name += "+textured_walls";
+#endif
+#ifdef FLOOR_CEILING
+    name += "+floor_ceiling";
+#endif
+#ifdef COLUMN_LOD
+    name += "+column_lod";
+#endif
+    return name.empty() ? "default" : name.substr(1);
+}
+
+// Escribe un cuadro (páginas de 8 filas, como el búfer de pantalla) como PBM binario (P4)
+bool writeFrame(const std::string &path, const uint8_t *frame) {
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+
+    fprintf(file, "P4\n%u %u\n", SCREEN_WIDTH, SCREEN_HEIGHT);
+    for (uint8_t y = 0; y < SCREEN_HEIGHT; y++) {
+        for (uint8_t x = 0; x < SCREEN_WIDTH; x += 8) {
+            uint8_t row = 0;
+            for (uint8_t i = 0; i < 8; i++) {
+                if (frame[(y / 8) * SCREEN_WIDTH + x + i] & (1 << (y & 7))) row |= 0x80 >> i;
+            }
+            fputc(row, file);
+        }
+    }
+    return fclose(file) == 0;
+}
+
+// Lee un PBM (P1 como el de dumpFrame() o P4) de la geometría de la pantalla en formato de páginas
+bool readFrame(const std::string &path, uint8_t *frame) {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+
+    char format[3] = {};
+    unsigned width = 0, height = 0;
+    bool ok = fscanf(file, "%2s %u %u", format, &width, &height) == 3 &&
+        width == SCREEN_WIDTH && height == SCREEN_HEIGHT && (!strcmp(format, "P1") || !strcmp(format, "P4"));
+    bool binary = ok && format[1] == '4';
+    if (binary) fgetc(file); // Separador tras la cabecera
+
+    memset(frame, 0, FRAME_BYTES);
+    for (uint8_t y = 0; ok && y < SCREEN_HEIGHT; y++) {
+        int row = 0;
+        for (uint8_t x = 0; ok && x < SCREEN_WIDTH; x++) {
+            int pixel;
+            if (binary) {
+                if ((x & 7) == 0) row = fgetc(file);
+                ok = row != EOF;
+                pixel = row & (0x80 >> (x & 7));
+            } else {
+                char c;
+                ok = fscanf(file, " %c", &c) == 1 && (c == '0' || c == '1');
+                pixel = c == '1';
+            }
+            if (pixel) frame[(y / 8) * SCREEN_WIDTH + x] |= 1 << (y & 7);
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+// Compara un cuadro con la referencia de la pose; escribe el cuadro y la diferencia si no coincide
+bool checkFrame(uint8_t pose, const uint8_t *frame, const std::string &golden_dir, uint16_t tolerance) {
+    uint8_t golden[FRAME_BYTES];
+    std::string name = "pose" + std::to_string(pose);
+    if (!readFrame(golden_dir + "/" + name + ".pbm", golden)) {
+        printf("SIN REFERENCIA pose %u (%s/%s.pbm; grábala con -r)\n", pose, golden_dir.c_str(), name.c_str());
+        return false;
+    }
+
+    uint8_t diff[FRAME_BYTES];
+    uint16_t pixels = 0;
+    for (uint16_t i = 0; i < FRAME_BYTES; i++) {
+        diff[i] = frame[i] ^ golden[i];
+        pixels += __builtin_popcount(diff[i]);
+    }
+    if (pixels == 0) return true;
+
+    printf("%s pose %u: %u píxeles distintos\n", pixels > tolerance ? "FALLO" : "APROX", pose, pixels);
+    mkdir("build", 0755);
+    mkdir("build/render_check", 0755);
+    writeFrame("build/render_check/" + name + ".pbm", frame);
+    writeFrame("build/render_check/" + name + "_diff.pbm", diff);
+    return pixels <= tolerance;
+}
+
+int main(int argc, char **argv) {
+    uint16_t tolerance = RENDER_CHECK_TOLERANCE;
+    bool record = false;
+    const char *compare = NULL;
+
+    int option;
+    while ((option = getopt(argc, argv, "t:rc:")) != -1) {
+        switch (option) {
+            case 't': tolerance = atoi(optarg); break;
+            case 'r': record = true; break;
+            case 'c': compare = optarg; break;
+            default:
+                fprintf(stderr, "uso: %s [-t tolerancia] [-r] [-c imagen.pbm pose]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    std::string golden_dir = "host/render_check/" + configName();
+    uint8_t frame[FRAME_BYTES];
+
+    if (compare) {
+        uint8_t pose = optind < argc ? atoi(argv[optind]) : 0;
+        if (!readFrame(compare, frame) || pose >= RENDER_CHECK_POSES) {
+            fprintf(stderr, "no se puede leer %s como PBM de %ux%u o la pose no existe\n", compare, SCREEN_WIDTH, SCREEN_HEIGHT);
+            return 1;
+        }
+        return checkFrame(pose, frame, golden_dir, tolerance) ? 0 : 1;
+    }
+
+    setup();
+    if (record) {
+        mkdir("host/render_check", 0755);
+        mkdir(golden_dir.c_str(), 0755);
+    }
+
+    uint8_t failures = 0;
+    for (uint8_t i = 0; i < RENDER_CHECK_POSES; i++) {
+        renderCheckPose(i);
+        memcpy(frame, display.getBuffer(), FRAME_BYTES);
+
+        if (record) {
+            std::string path = golden_dir + "/pose" + std::to_string(i) + ".pbm";
+            if (!writeFrame(path, frame)) {
+                fprintf(stderr, "no se puede escribir %s\n", path.c_str());
+                return 1;
+            }
+        } else if (!checkFrame(i, frame, golden_dir, tolerance)) {
+            failures++;
+        }
+    }
+
+    printf("%s: %s %u poses, %u fallos\n", configName().c_str(), record ? "grabadas" : "comprobadas", (unsigned) RENDER_CHECK_POSES, failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,239 @@
+/*
+  Medición de ciclos de la imagen real del ATmega328P en el emulador simavr.
+
+  Carga el .elf compilado con BENCH_SIMAVR y lo ejecuta a 16 MHz. La escena BENCH juega el recorrido
+  de bench.h y profile.h escribe marcas en GPIOR0 al empezar cada cuadro, al acabar cada etapa y al
+  acabar la medición; aquí se cuentan los ciclos exactos entre marcas. El bus I2C tiene un esclavo que
+  confirma todos los bytes, así que display.display() tarda lo mismo que con la pantalla conectada.
+
+  Con la tabla de símbolos de avr-nm, los ciclos de los cuadros se reparten además entre funciones:
+  cada instrucción cuenta para la función que la contiene (ciclos propios, sin los de las funciones
+  a las que llama; las interrupciones cuentan para su ISR).
+
+  La primera línea resume los ciclos medios por cuadro de cada etapa, en el formato de
+  profileReport(), para comparar mediciones de distintos commits.
+
+  Uso: simavr_bench doom.ino.elf [símbolos de avr-nm -n]
+*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim_avr.h"
+#include "sim_elf.h"
+#include "sim_io.h"
+#include "avr_twi.h"
+
+#define FREQUENCY         16000000
+#define GPIOR0_ADDR       0x3E                      // GPIOR0 (I/O 0x1E) en el espacio de datos
+#define MARK_BEGIN        0x80                      // PROFILE_MARK_BEGIN de profile.h
+#define MARK_END          0x81                      // PROFILE_MARK_END de profile.h
+#define STAGE_COUNT       5                         // PROFILE_STAGE_COUNT de profile.h
+#define MAX_CYCLES        ((uint64_t) FREQUENCY * 600) // Tiempo emulado máximo (10 minutos)
+#define TOP_FUNCTIONS     30                        // Funciones listadas
+
+static const char *stage_names[STAGE_COUNT] = { "upd", "flw", "map", "ent", "dsp" };
+
+// Función de la tabla de símbolos y ciclos propios acumulados
+struct function {
+    uint32_t address;
+    char name[96];
+    uint64_t cycles;
+};
+
+static avr_t *avr;
+static avr_irq_t *twi_input;
+
+static int in_frame = 0;                 // Entre PROFILE_MARK_BEGIN y el final de la última etapa
+static int finished = 0;                 // Se ha recibido PROFILE_MARK_END
+static uint32_t frames = 0;
+static avr_cycle_count_t frame_start;
+static avr_cycle_count_t last_mark;
+static uint64_t stage_cycles[STAGE_COUNT];
+static uint64_t frame_cycles = 0;
+static uint64_t frame_min = UINT64_MAX;
+static uint64_t frame_max = 0;
+
+static struct function *functions = NULL;
+static int function_count = 0;
+static uint64_t unknown_cycles = 0;      // Ciclos fuera de las funciones conocidas
+
+// Escritura en GPIOR0: marcas de profile.h
+static void markWrite(struct avr_t *avr, avr_io_addr_t addr, uint8_t v, void *param) {
+    avr_cycle_count_t now = avr->cycle;
+    avr->data[addr] = v;
+
+    if (v == MARK_BEGIN) {
+        in_frame = 1;
+        frame_start = now;
+        last_mark = now;
+        frames++;
+    } else if (v == MARK_END) {
+        in_frame = 0;
+        finished = 1;
+    } else if (v < STAGE_COUNT && in_frame) {
+        stage_cycles[v] += now - last_mark;
+        last_mark = now;
+
+        if (v == STAGE_COUNT - 1) {
+            uint64_t cycles = now - frame_start;
+            frame_cycles += cycles;
+            if (cycles < frame_min) frame_min = cycles;
+            if (cycles > frame_max) frame_max = cycles;
+            in_frame = 0;
+        }
+    }
+}
+
+// Esclavo I2C que confirma cualquier dirección y cualquier byte (sustituye al SSD1306)
+static void twiOutput(struct avr_irq_t *irq, uint32_t value, void *param) {
+    avr_twi_msg_irq_t msg;
+    msg.u.v = value;
+
+    if (msg.u.twi.msg & (TWI_COND_START | TWI_COND_WRITE)) {
+        avr_raise_irq(twi_input, avr_twi_irq_msg(TWI_COND_ACK, msg.u.twi.addr, 1));
+    }
+    if (msg.u.twi.msg & TWI_COND_READ) {
+        avr_raise_irq(twi_input, avr_twi_irq_msg(TWI_COND_READ, msg.u.twi.addr, 0));
+    }
+}
+
+static int compareAddress(const void *a, const void *b) {
+    const struct function *fa = a;
+    const struct function *fb = b;
+    return fa->address < fb->address ? -1 : fa->address > fb->address;
+}
+
+static int compareCycles(const void *a, const void *b) {
+    const struct function *fa = a;
+    const struct function *fb = b;
+    return fa->cycles > fb->cycles ? -1 : fa->cycles < fb->cycles;
+}
+
+// Lee las funciones de la salida de avr-nm -n (dirección, tipo, nombre)
+static void loadSymbols(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        exit(1);
+    }
+
+    char line[512];
+    int capacity = 0;
+    while (fgets(line, sizeof(line), file)) {
+        unsigned int address;
+        char type;
+        char name[400];
+        if (sscanf(line, "%x %c %399[^\n]", &address, &type, name) != 3) continue;
+        if (type != 'T' && type != 't' && type != 'W' && type != 'w') continue;
+
+        if (function_count == capacity) {
+            capacity = capacity ? capacity * 2 : 256;
+            functions = realloc(functions, capacity * sizeof(struct function));
+        }
+        functions[function_count].address = address;
+        snprintf(functions[function_count].name, sizeof(functions[function_count].name), "%s", name);
+        functions[function_count].cycles = 0;
+        function_count++;
+    }
+    fclose(file);
+
+    qsort(functions, function_count, sizeof(struct function), compareAddress);
+}
+
+// Función que contiene la dirección de flash pc (en bytes), o NULL
+static struct function *findFunction(uint32_t pc) {
+    int low = 0;
+    int high = function_count - 1;
+    struct function *found = NULL;
+
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        if (functions[middle].address <= pc) {
+            found = &functions[middle];
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return found;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "uso: %s doom.ino.elf [símbolos de avr-nm -n]\n", argv[0]);
+        return 1;
+    }
+
+    elf_firmware_t firmware;
+    memset(&firmware, 0, sizeof(firmware));
+    if (elf_read_firmware(argv[1], &firmware) != 0) {
+        fprintf(stderr, "no se pudo leer %s\n", argv[1]);
+        return 1;
+    }
+    strcpy(firmware.mmcu, "atmega328p");
+    firmware.frequency = FREQUENCY;
+
+    avr = avr_make_mcu_by_name(firmware.mmcu);
+    if (!avr) {
+        fprintf(stderr, "simavr no conoce %s\n", firmware.mmcu);
+        return 1;
+    }
+    avr_init(avr);
+    avr_load_firmware(avr, &firmware);
+
+    avr_register_io_write(avr, GPIOR0_ADDR, markWrite, NULL);
+    twi_input = avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_INPUT);
+    avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_OUTPUT), twiOutput, NULL);
+
+    if (argc > 2) loadSymbols(argv[2]);
+
+    int state = cpu_Running;
+    while (!finished && state != cpu_Done && state != cpu_Crashed && avr->cycle < MAX_CYCLES) {
+        if (in_frame && function_count) {
+            uint32_t pc = avr->pc;
+            avr_cycle_count_t start = avr->cycle;
+            state = avr_run(avr);
+
+            struct function *function = findFunction(pc);
+            if (function) function->cycles += avr->cycle - start;
+            else unknown_cycles += avr->cycle - start;
+        } else {
+            state = avr_run(avr);
+        }
+    }
+
+    if (!finished) {
+        fprintf(stderr, "la medición no terminó (%u cuadros, estado %d, %llu ciclos); ¿se compiló con BENCH_SIMAVR?\n",
+                frames, state, (unsigned long long) avr->cycle);
+        return 1;
+    }
+    if (frames == 0) {
+        fprintf(stderr, "no se recibió ningún cuadro\n");
+        return 1;
+    }
+
+    // Resumen en el formato de profileReport(), en ciclos por cuadro
+    for (int i = 0; i < STAGE_COUNT; i++) printf("%s %llu ", stage_names[i], (unsigned long long) (stage_cycles[i] / frames));
+    printf("total %llu\n", (unsigned long long) (frame_cycles / frames));
+
+    printf("\n%u cuadros, %llu ciclos por cuadro (mín %llu, máx %llu), %.2f ms a %u MHz\n",
+           frames, (unsigned long long) (frame_cycles / frames), (unsigned long long) frame_min,
+           (unsigned long long) frame_max, frame_cycles / frames * 1000.0 / FREQUENCY, FREQUENCY / 1000000);
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        printf("  %s %12llu ciclos/cuadro %6.1f%%\n", stage_names[i], (unsigned long long) (stage_cycles[i] / frames),
+               100.0 * stage_cycles[i] / frame_cycles);
+    }
+
+    if (function_count) {
+        qsort(functions, function_count, sizeof(struct function), compareCycles);
+        printf("\nCiclos propios por cuadro de las funciones:\n");
+        for (int i = 0; i < function_count && i < TOP_FUNCTIONS && functions[i].cycles; i++) {
+            printf("  %12llu %6.1f%%  %s\n", (unsigned long long) (functions[i].cycles / frames),
+                   100.0 * functions[i].cycles / frame_cycles, functions[i].name);
+        }
+        if (unknown_cycles) printf("  %12llu          (fuera de las funciones)\n", (unsigned long long) (unknown_cycles / frames));
+    }
+    return 0;
+}
@@ -0,0 +1,196 @@
+/*
+  Simulador de partidas sin pantalla en el ordenador (HOST_BUILD).
+
+  Juega sesiones de sto_level_1 con un bot en lugar del jugador, a paso fijo y sin esperar al reloj:
+  cada sesión tiene su propio GameState, así que los hilos simulan partidas a la vez. No se dibuja
+  nada ni suena nada (host_headless); para que los enemigos aparezcan como al jugar, cada paso lanza
+  uno de cada -r rayos de la pantalla con spawnVisibleEntities() y ordena las entidades como al
+  dibujar (updateViewCache()). El reloj de cada hilo es manual y
+  avanza TICK_TIME_US por paso, así que una sesión da el mismo resultado con la misma semilla.
+
+  Bots:
+  - random: mantiene una combinación aleatoria de botones durante unos pasos.
+  - scripted: avanza, gira al chocar y apunta y dispara al enemigo visible más cercano.
+
+  Uso: simulate [-n sesiones] [-j hilos] [-t pasos máximos] [-b random|scripted] [-s semilla] [-r muestreo de rayos]
+*/
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+#include <getopt.h>
+
+#include "doom_sketch.cpp"
+
+// Resultado de una sesión
+struct SessionResult {
+    uint32_t ticks;          // Pasos simulados
+    bool died;               // El jugador murió antes del límite de pasos
+    uint16_t shots;          // Disparos del jugador
+    uint32_t entity_sum;     // Suma de entidades activas en cada paso
+    uint8_t entity_max;      // Máximo de entidades activas
+};
+
+// Estado del bot de una sesión
+struct Bot {
+    bool scripted;
+    std::mt19937 rng;
+    uint16_t input;          // Botones que mantiene
+    uint8_t hold;            // Pasos que le quedan con input
+    Coords last_pos;         // Posición del paso anterior, para detectar choques
+};
+
+// Enemigo vivo y visible más cercano, o -1
+int8_t nearestVisibleEnemy() {
+    int8_t nearest = -1;
+    for (uint8_t i = 0; i < game.num_entities; i++) {
+        Entity *e = &game.entity[i];
+        if (uid_get_type(e->uid) != E_ENEMY || e->state == S_DEAD || e->state == S_HIDDEN || !e->sight) continue;
+        if (nearest < 0 || e->distance < game.entity[nearest].distance) nearest = i;
+    }
+    return nearest;
+}
+
+// Botones del bot en este paso
+uint16_t botInput(Bot *bot) {
+    if (!bot->scripted) {
+        if (bot->hold == 0) {
+            static const uint16_t moves[] = { 0, UP, DOWN, LEFT, RIGHT, UP | LEFT, UP | RIGHT };
+            bot->input = moves[bot->rng() % 7] | (bot->rng() % 3 == 0 ? Y : 0);
+            bot->hold = 4 + bot->rng() % 12;
+        }
+        bot->hold--;
+        return bot->input;
+    }
+
+    int8_t target = nearestVisibleEnemy();
+    if (target >= 0) {
+        // Gira hacia el enemigo y dispara cuando está delante; suelta Y entre disparos para rearmar
+        Coords *pos = &game.entity[target].pos;
+        double to_x = pos->x - game.player.pos.x;
+        double to_y = pos->y - game.player.pos.y;
+        double cross = game.player.dir.x * to_y - game.player.dir.y * to_x;
+        double dot = game.player.dir.x * to_x + game.player.dir.y * to_y;
+        double len = sqrt(to_x * to_x + to_y * to_y);
+
+        if (dot > 0 && abs(cross) < len * sin(ROT_SPEED)) return game.gun_fired ? 0 : Y;
+        return cross > 0 ? LEFT : RIGHT;
+    }
+
+    if (bot->hold > 0) {
+        bot->hold--;
+        return bot->input;
+    }
+
+    // Avanza; si no se movió en el paso anterior, gira un rato hacia un lado al azar
+    bool stuck = game.player.velocity != 0 && abs(game.player.pos.x - bot->last_pos.x) + abs(game.player.pos.y - bot->last_pos.y) < 0.01;
+    bot->last_pos = game.player.pos;
+    if (stuck) {
+        bot->input = bot->rng() % 2 ? LEFT : RIGHT;
+        bot->hold = 2 + bot->rng() % 12;
+        return bot->input;
+    }
+    return UP;
+}
+
+// Juega una sesión hasta la muerte del jugador o max_ticks pasos
+SessionResult runSession(bool scripted, uint32_t seed, uint32_t max_ticks, uint8_t ray_sample) {
+    GameState state = GameState();
+    active_game = &state;
+    host_clock_us = 0;
+    initializeLevel<Level1>();
+
+    Bot bot = { scripted, std::mt19937(seed), 0, 0, game.player.pos };
+    SessionResult result = { 0, false, 0, 0, 0 };
+
+    while (result.ticks < max_ticks) {
+        if (ray_sample > 0) spawnVisibleEntities<RenderDefault>(sto_level_1, ray_sample);
+        updateViewCache();
+        updateGame(sto_level_1, botInput(&bot));
+        host_clock_us += TICK_TIME_US;
+        result.ticks++;
+
+        if (game.gun_pos == GUN_SHOT_POS) result.shots++;
+        result.entity_sum += game.num_entities;
+        result.entity_max = max(result.entity_max, game.num_entities);
+
+        if (game.player.health == 0) {
+            result.died = true;
+            break;
+        }
+    }
+
+    active_game = &default_game;
+    return result;
+}
+
+int main(int argc, char **argv) {
+    uint32_t sessions = 1000;
+    uint8_t threads = max(1u, std::thread::hardware_concurrency());
+    uint32_t max_ticks = 10 * 60 * 1000 / FRAME_TIME; // 10 minutos de juego
+    bool scripted = true;
+    uint32_t seed = 1;
+    uint8_t ray_sample = 4;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:j:t:b:s:r:")) != -1) {
+        switch (option) {
+            case 'n': sessions = atoi(optarg); break;
+            case 'j': threads = max(1, atoi(optarg)); break;
+            case 't': max_ticks = atoi(optarg); break;
+            case 'b': scripted = strcmp(optarg, "random") != 0; break;
+            case 's': seed = atoi(optarg); break;
+            case 'r': ray_sample = atoi(optarg); break;
+            default:
+                fprintf(stderr, "uso: %s [-n sesiones] [-j hilos] [-t pasos] [-b random|scripted] [-s semilla] [-r muestreo de rayos]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    host_manual_clock = true;
+    host_headless = true;
+
+    // Cada hilo juega las sesiones i, i + threads, ... y escribe solo sus resultados
+    std::vector<SessionResult> results(sessions);
+    std::vector<std::thread> workers;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint8_t t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            for (uint32_t i = t; i < sessions; i += threads) {
+                results[i] = runSession(scripted, seed + i, max_ticks, ray_sample);
+            }
+        });
+    }
+    for (std::thread &worker : workers) worker.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    uint64_t total_ticks = 0;
+    uint64_t total_shots = 0;
+    uint64_t entity_sum = 0;
+    uint8_t entity_max = 0;
+    std::vector<double> deaths;
+    for (const SessionResult &result : results) {
+        total_ticks += result.ticks;
+        total_shots += result.shots;
+        entity_sum += result.entity_sum;
+        entity_max = max(entity_max, result.entity_max);
+        if (result.died) deaths.push_back(result.ticks * FRAME_TIME / 1000);
+    }
+    std::sort(deaths.begin(), deaths.end());
+
+    printf("%u sesiones (%s), %u hilos, %.2f s\n", sessions, scripted ? "scripted" : "random", threads, elapsed.count());
+    printf("muertes: %zu (%.1f%%)\n", deaths.size(), sessions ? 100.0 * deaths.size() / sessions : 0);
+    if (!deaths.empty()) {
+        double sum = 0;
+        for (double t : deaths) sum += t;
+        printf("tiempo hasta morir: media %.1f s, mediana %.1f s, min %.1f s, max %.1f s\n",
+               sum / deaths.size(), deaths[deaths.size() / 2], deaths.front(), deaths.back());
+    }
+    printf("disparos: %.1f por sesión, %.2f por minuto\n",
+           (double) total_shots / max(1u, sessions), total_ticks ? total_shots * 60000.0 / (total_ticks * FRAME_TIME) : 0);
+    printf("entidades: media %.2f, máximo %u\n", total_ticks ? (double) entity_sum / total_ticks : 0, entity_max);
+    printf("pasos: %llu, %.0f pasos/s (x%.0f tiempo real)\n",
+           (unsigned long long) total_ticks, total_ticks / elapsed.count(),
+           total_ticks * FRAME_TIME / 1000 / elapsed.count());
+    return 0;
+}
@@ -0,0 +1,8 @@
+#ifndef _host_atomic_h
+#define _host_atomic_h
+
+// En el ordenador no hay interrupciones: el bloque se ejecuta una vez sin más
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_BLOCK(type)    for (bool atomic_once = true; atomic_once; atomic_once = false)
+
+#endif
@@ -88,3 +88,8 @@ bool input_down() { return digitalRead(K_DOWN) == INPUT_STATE; }
 bool input_fire() { return digitalRead(K_FIRE) == INPUT_STATE; }
 
 #endif
+
+uint16_t input_read() {
+  return (input_up() ? UP : 0) | (input_down() ? DOWN : 0) | (input_left() ? LEFT : 0)
+         | (input_right() ? RIGHT : 0) | (input_fire() ? Y : 0);
+}
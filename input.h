@@ -59,6 +59,13 @@ bool input_right();
  */
 bool input_fire();
 
+/**
+ * Lee los controles del juego como máscara de BUTTONS: UP, DOWN, LEFT, RIGHT e Y para el disparo,
+ * también con botones individuales. Es la entrada de cada paso de updateGame().
+ * @return Máscara con los botones presionados.
+ */
+uint16_t input_read();
+
 #ifdef SNES_CONTROLLER
 /**
  * Verifica si el botón "Start" está activo (solo para SNES Controller).
@@ -0,0 +1,154 @@
+#ifndef _level_compiler_h
+#define _level_compiler_h
+
+#include <avr/pgmspace.h>
+#include "constants.h"
+#include "types.h"
+
+/*
+  Compilación de niveles escritos en ASCII.
+
+  Un nivel es un struct con el mapa como cadena constexpr de LEVEL_HEIGHT filas de LEVEL_WIDTH
+  caracteres (leyenda de types.h), de arriba abajo: la primera fila es y = LEVEL_HEIGHT - 1, igual
+  que el orden de filas invertido que usa getBlockAt(). CompiledLevel<Map> genera al compilar:
+
+  - Blocks::data: el nivel empaquetado a 4 bits por celda, el formato que leen getBlockAt() y el resto
+    del motor.
+  - Walls::data: el mapa de paredes de 1 bit por celda (WALL_BITMAP).
+  - Objects::data: con el mismo formato, las celdas de Entities::data; getWallOrBlockAt() solo lee el
+    nivel empaquetado en ellas.
+  - Entities::data: las celdas con puertas, enemigos, objetos y la salida, en el orden de y y x
+    crecientes, terminada con una celda E_FLOOR.
+  - player_x, player_y: la posición inicial del jugador (P).
+
+  Las tablas están en PROGMEM y solo acaban en el binario las que se usan. C++11 no permite bucles en
+  las funciones constexpr, así que las búsquedas dividen el mapa en mitades para no superar el límite
+  de recursión del compilador, y los índices de cada tabla se expanden como paquetes de plantilla.
+*/
+
+// Índices 0..N-1 como paquete de plantilla; MakeLevelIndices duplica la lista para tener profundidad log(N)
+template <uint16_t... I> struct LevelIndices {};
+
+template <class A, class B> struct ConcatLevelIndices;
+template <uint16_t... A, uint16_t... B>
+struct ConcatLevelIndices<LevelIndices<A...>, LevelIndices<B...>> {
+  typedef LevelIndices<A..., uint16_t(sizeof...(A) + B)...> type;
+};
+
+template <uint16_t N> struct MakeLevelIndices {
+  typedef typename ConcatLevelIndices<typename MakeLevelIndices<N / 2>::type,
+                                      typename MakeLevelIndices<N - N / 2>::type>::type type;
+};
+template <> struct MakeLevelIndices<0> { typedef LevelIndices<> type; };
+template <> struct MakeLevelIndices<1> { typedef LevelIndices<0> type; };
+
+// Bloque de un carácter del mapa; 0xFF si no está en la leyenda
+constexpr uint8_t levelBlock(char c) {
+  return c == '.' ? E_FLOOR
+       : c == '#' ? E_WALL
+       : c == 'P' ? E_PLAYER
+       : c == 'E' ? E_ENEMY
+       : c == 'D' ? E_DOOR
+       : c == 'L' ? E_LOCKEDDOOR
+       : c == 'X' ? E_EXIT
+       : c == 'M' ? E_MEDIKIT
+       : c == 'K' ? E_KEY
+       : 0xFF;
+}
+
+// Carácter de la celda n-ésima recorriendo el nivel por y y x crecientes (el orden de initializeLevel())
+constexpr char levelScanCell(const char *map, uint16_t n) {
+  return map[(LEVEL_HEIGHT - 1 - n / LEVEL_WIDTH) * LEVEL_WIDTH + n % LEVEL_WIDTH];
+}
+
+// Celdas que initializeLevel() registra: puertas, enemigos, objetos y la salida. c = 0 las selecciona;
+// cualquier otro carácter selecciona solo ese carácter
+constexpr bool levelMatches(char cell, char c) {
+  return c ? cell == c : cell != '.' && cell != '#' && cell != 'P';
+}
+
+// Número de celdas de [from, to) que cumplen levelMatches()
+constexpr uint16_t levelCount(const char *map, char c, uint16_t from, uint16_t to) {
+  return to - from == 1 ? levelMatches(levelScanCell(map, from), c)
+       : levelCount(map, c, from, from + (to - from) / 2) + levelCount(map, c, from + (to - from) / 2, to);
+}
+
+// Posición en el recorrido de la celda número k (desde 0) de [from, to) que cumple levelMatches()
+constexpr uint16_t levelFind(const char *map, char c, uint16_t k, uint16_t from, uint16_t to) {
+  return to - from == 1 ? from
+       : k < levelCount(map, c, from, from + (to - from) / 2)
+         ? levelFind(map, c, k, from, from + (to - from) / 2)
+         : levelFind(map, c, k - levelCount(map, c, from, from + (to - from) / 2), from + (to - from) / 2, to);
+}
+
+// Indica si todos los caracteres de [from, to) están en la leyenda
+constexpr bool levelValid(const char *map, uint16_t from, uint16_t to) {
+  return to - from == 1 ? levelBlock(map[from]) != 0xFF
+       : levelValid(map, from, from + (to - from) / 2) && levelValid(map, from + (to - from) / 2, to);
+}
+
+// Byte i del nivel empaquetado: dos celdas consecutivas del mapa, la de x par en el nibble alto
+constexpr uint8_t levelPackedByte(const char *map, uint16_t i) {
+  return levelBlock(map[i * 2]) << 4 | levelBlock(map[i * 2 + 1]);
+}
+
+// Bits bit..7 de un byte de un mapa de bits, a partir de la celda first de la cadena; c como en levelMatches()
+constexpr uint8_t levelBitmapBits(const char *map, char c, uint16_t first, uint8_t bit) {
+  return bit == 8 ? 0 : levelMatches(map[first + bit], c) << bit | levelBitmapBits(map, c, first, bit + 1);
+}
+
+// Byte i de un mapa de bits: fila y = i / WALL_ROW_BYTES, celdas x = (i % WALL_ROW_BYTES) * 8 a + 7
+constexpr uint8_t levelBitmapByte(const char *map, char c, uint16_t i) {
+  return levelBitmapBits(map, c, (LEVEL_HEIGHT - 1 - i / WALL_ROW_BYTES) * LEVEL_WIDTH + i % WALL_ROW_BYTES * 8, 0);
+}
+
+// Entidad de la celda n del recorrido
+constexpr SpawnCell levelEntity(const char *map, uint16_t n) {
+  return {levelBlock(levelScanCell(map, n)), uint8_t(n % LEVEL_WIDTH), uint8_t(n / LEVEL_WIDTH)};
+}
+
+template <class Map, class Indices> struct LevelBlocks;
+template <class Map, uint16_t... I> struct LevelBlocks<Map, LevelIndices<I...>> {
+  static const uint8_t data[sizeof...(I)] PROGMEM;
+};
+template <class Map, uint16_t... I>
+const uint8_t LevelBlocks<Map, LevelIndices<I...>>::data[sizeof...(I)] PROGMEM = {
+  levelPackedByte(Map::cells, I)...
+};
+
+template <class Map, char C, class Indices> struct LevelBitmap;
+template <class Map, char C, uint16_t... I> struct LevelBitmap<Map, C, LevelIndices<I...>> {
+  static const uint8_t data[sizeof...(I)] PROGMEM;
+};
+template <class Map, char C, uint16_t... I>
+const uint8_t LevelBitmap<Map, C, LevelIndices<I...>>::data[sizeof...(I)] PROGMEM = {
+  levelBitmapByte(Map::cells, C, I)...
+};
+
+template <class Map, class Indices> struct LevelEntities;
+template <class Map, uint16_t... I> struct LevelEntities<Map, LevelIndices<I...>> {
+  static const SpawnCell data[sizeof...(I) + 1] PROGMEM;
+};
+template <class Map, uint16_t... I>
+const SpawnCell LevelEntities<Map, LevelIndices<I...>>::data[sizeof...(I) + 1] PROGMEM = {
+  levelEntity(Map::cells, levelFind(Map::cells, 0, I, 0, LEVEL_WIDTH * LEVEL_HEIGHT))...,
+  {E_FLOOR, 0, 0}
+};
+
+template <class Map>
+struct CompiledLevel {
+  static_assert(sizeof(Map::cells) == LEVEL_WIDTH * LEVEL_HEIGHT + 1, "el mapa debe tener LEVEL_HEIGHT filas de LEVEL_WIDTH celdas");
+  static_assert(levelValid(Map::cells, 0, LEVEL_WIDTH * LEVEL_HEIGHT), "el mapa tiene caracteres fuera de la leyenda de types.h");
+  static_assert(levelCount(Map::cells, 'P', 0, LEVEL_WIDTH * LEVEL_HEIGHT) == 1, "el mapa debe tener un único inicio P");
+
+  static constexpr uint16_t player = levelFind(Map::cells, 'P', 0, 0, LEVEL_WIDTH * LEVEL_HEIGHT);
+  static constexpr uint8_t player_x = player % LEVEL_WIDTH;
+  static constexpr uint8_t player_y = player / LEVEL_WIDTH;
+
+  typedef LevelBlocks<Map, typename MakeLevelIndices<LEVEL_SIZE>::type> Blocks;
+  typedef LevelBitmap<Map, '#', typename MakeLevelIndices<WALL_BITMAP_SIZE>::type> Walls;
+  typedef LevelBitmap<Map, 0, typename MakeLevelIndices<WALL_BITMAP_SIZE>::type> Objects;
+  typedef LevelEntities<Map, typename MakeLevelIndices<levelCount(Map::cells, 0, 0, LEVEL_WIDTH * LEVEL_HEIGHT)>::type> Entities;
+};
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef _profile_h
+#define _profile_h
+
+#include "constants.h"
+
+/*
+  Medición del tiempo de cada etapa del cuadro.
+
+  Con PROFILE_STAGES definido, profileStage() suma los microsegundos transcurridos desde la
+  etapa anterior y profileReport() imprime por Serial la media de cada etapa cada PROFILE_FRAMES
+  cuadros. profileRay() y profileRead() cuentan los rayos de castRay() y sus lecturas del nivel en
+  PROGMEM, que se imprimen como lecturas por rayo. Sin PROFILE_STAGES las llamadas desaparecen.
+
+  Con BENCH_SIMAVR las etapas no se miden en el microcontrolador: cada llamada escribe una marca en
+  GPIOR0 (una sola instrucción out) y host/simavr_bench.c cuenta los ciclos exactos entre marcas en
+  el emulador. profileBegin() escribe PROFILE_MARK_BEGIN, profileStage() el número de la etapa y
+  profileEnd() PROFILE_MARK_END al acabar la medición.
+*/
+
+// Etapas del cuadro de juego, en el orden en que se ejecutan
+#define PROFILE_UPDATE      0           // Entrada, jugador y entidades
+#define PROFILE_FLOW        1           // Campo de flujo de los enemigos
+#define PROFILE_MAP         2           // renderMap()
+#define PROFILE_ENTITIES    3           // renderEntities() y arma
+#define PROFILE_DISPLAY     4           // HUD y envío del búfer a la pantalla
+#define PROFILE_STAGE_COUNT 5
+
+// Marcas de GPIOR0 fuera de las etapas (BENCH_SIMAVR)
+#define PROFILE_MARK_BEGIN  0x80        // Inicio de un cuadro
+#define PROFILE_MARK_END    0x81        // Fin de la medición
+
+#if defined(BENCH_SIMAVR)
+
+// Marca el inicio del cuadro
+void profileBegin() {
+    GPIOR0 = PROFILE_MARK_BEGIN;
+}
+
+// Marca el final de una etapa
+void profileStage(uint8_t stage) {
+    GPIOR0 = stage;
+}
+
+// Marca el final de la medición
+void profileEnd() {
+    GPIOR0 = PROFILE_MARK_END;
+}
+
+#define profileReport()
+#define profileRay()
+#define profileRead()
+
+#elif defined(PROFILE_STAGES)
+
+const char profile_names[] PROGMEM = "upd flw map ent dsp ";
+
+uint32_t profile_time[PROFILE_STAGE_COUNT]; // Microsegundos acumulados por etapa
+uint32_t profile_last = 0;                  // Marca de tiempo de la última etapa
+uint8_t profile_frames = 0;                 // Cuadros acumulados
+uint16_t profile_rays = 0;                  // Rayos lanzados
+uint16_t profile_reads = 0;                 // Lecturas del nivel (y de su tabla de distancias)
+
+// Marca el inicio del cuadro
+void profileBegin() {
+    profile_last = micros();
+}
+
+// Cierra una etapa y acumula su duración
+void profileStage(uint8_t stage) {
+    uint32_t now = micros();
+    profile_time[stage] += now - profile_last;
+    profile_last = now;
+}
+
+// Cuenta un rayo
+void profileRay() {
+    profile_rays++;
+}
+
+// Cuenta una lectura del nivel
+void profileRead() {
+    profile_reads++;
+}
+
+// Imprime la media por etapa cada PROFILE_FRAMES cuadros
+void profileReport() {
+    if (++profile_frames < PROFILE_FRAMES) return;
+
+    for (uint8_t i = 0; i < PROFILE_STAGE_COUNT; i++) {
+        for (uint8_t c = 0; c < 4; c++) Serial.print((char) pgm_read_byte(profile_names + i * 4 + c));
+        Serial.print(profile_time[i] / PROFILE_FRAMES);
+        Serial.print(' ');
+        profile_time[i] = 0;
+    }
+    Serial.print(F("lec "));
+    Serial.print(profile_rays ? (double) profile_reads / profile_rays : 0);
+    Serial.println();
+    profile_rays = 0;
+    profile_reads = 0;
+    profile_frames = 0;
+}
+
+#define profileEnd()
+
+#else
+
+#define profileBegin()
+#define profileStage(stage)
+#define profileEnd()
+#define profileReport()
+#define profileRay()
+#define profileRead()
+
+#endif
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef _render_check_h
+#define _render_check_h
+
+#include <avr/pgmspace.h>
+#include "constants.h"
+
+/*
+  Poses fijas de sto_level_1 usadas por la escena RENDER_CHECK y por host/render_check.cpp.
+
+  Cada pose se renderiza con renderMap(), renderEntities(), renderGun() y el HUD. La escena compara
+  el hash del búfer con la tabla de la configuración compilada (por defecto, TEXTURED_WALLS,
+  FLOOR_CEILING o COLUMN_LOD; el resto de opciones no cambian la imagen) y envía por Serial en
+  formato PBM los cuadros que no coinciden. Las combinaciones de esas opciones no tienen tabla: la
+  escena envía todos los cuadros.
+
+  host/render_check.cpp compara los cuadros byte a byte con las imágenes de host/render_check/ y
+  acepta hasta RENDER_CHECK_TOLERANCE píxeles distintos, por ejemplo al comparar un cuadro enviado
+  por la placa (float de 32 bits) con la referencia del ordenador (double).
+
+  Tras un cambio intencionado en el renderizado, define RENDER_CHECK_RECORD y copia aquí la tabla
+  impresa por Serial, y vuelve a grabar las imágenes con host/render_check -r.
+*/
+
+// Pose de verificación: posición en medias celdas y orientación (índice de render_check_headings)
+struct RenderCheckPose {
+  uint8_t x;
+  uint8_t y;
+  uint8_t heading;
+};
+
+// Direcciones en pasos de 45 grados (* 1/64), empezando hacia la derecha en sentido antihorario
+const static int8_t render_check_headings[8][2] PROGMEM = {
+  {  64,   0 }, {  45,  45 }, {   0,  64 }, { -45,  45 },
+  { -64,   0 }, { -45, -45 }, {   0, -64 }, {  45, -45 },
+};
+
+const static RenderCheckPose render_check_poses[] PROGMEM = {
+  { 59, 21, 0 },   // Inicio del jugador mirando al pasillo de puertas
+  { 59, 21, 2 },   // Inicio del jugador mirando a la pared cercana
+  { 65, 57, 3 },   // Sala grande junto a un enemigo
+  {  5, 31, 0 },   // Pasillo largo con enemigos
+  { 15, 55, 1 },   // Sala de la llave
+  { 57, 19, 5 },   // Esquina a poca distancia de la pared
+};
+
+#define RENDER_CHECK_POSES    (sizeof(render_check_poses) / sizeof(RenderCheckPose))
+
+// Hashes de referencia de cada configuración, grabados con doubles de 32 bits como en AVR
+#if !defined(TEXTURED_WALLS) && !defined(FLOOR_CEILING) && !defined(COLUMN_LOD)
+#define RENDER_CHECK_HASHES
+const static uint32_t render_check_hashes[RENDER_CHECK_POSES] PROGMEM = {
+  0xF1331F0,
+  0xDB738282,
+  0x6D50DB43,
+  0x928CAF72,
+  0x2F1F6AA1,
+  0xD0137E16,
+};
+#elif defined(TEXTURED_WALLS) && !defined(FLOOR_CEILING) && !defined(COLUMN_LOD)
+#define RENDER_CHECK_HASHES
+const static uint32_t render_check_hashes[RENDER_CHECK_POSES] PROGMEM = {
+  0x481E80C1,
+  0x97366B52,
+  0x272F7C19,
+  0x17AC652D,
+  0x760B935C,
+  0x6E24E127,
+};
+#elif defined(FLOOR_CEILING) && !defined(TEXTURED_WALLS) && !defined(COLUMN_LOD)
+#define RENDER_CHECK_HASHES
+const static uint32_t render_check_hashes[RENDER_CHECK_POSES] PROGMEM = {
+  0x3EE1D3B2,
+  0x6079053C,
+  0xA9DE33DF,
+  0xC1C17A0,
+  0x264B5797,
+  0xD0137E16,
+};
+#elif defined(COLUMN_LOD) && !defined(TEXTURED_WALLS) && !defined(FLOOR_CEILING)
+#define RENDER_CHECK_HASHES
+const static uint32_t render_check_hashes[RENDER_CHECK_POSES] PROGMEM = {
+  0xF1331F0,
+  0xDB738282,
+  0x6D50DB43,
+  0x928CAF72,
+  0x2F1F6AA1,
+  0xD0137E16,
+};
+#endif
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef _render_config_h
+#define _render_config_h
+
+#include "constants.h"
+
+/*
+  Configuración del renderizado como tipo.
+
+  renderMap(), drawVLine() y drawSprites() (y las funciones que usan) reciben la configuración como
+  parámetro de plantilla, así que cada combinación se compila como una versión propia con los
+  bucles por columna y la rama de escritura (bytes de página o drawPixel) resueltos al compilar.
+  El juego solo usa RenderDefault, construida con las macros de constants.h, y el binario contiene
+  únicamente esa versión; en el host se pueden instanciar varias a la vez para compararlas.
+*/
+
+// Tipo entero más pequeño que cubre el rango pedido
+template <bool Small> struct CoordType { typedef int16_t type; };
+template <> struct CoordType<true> { typedef int8_t type; };
+template <bool Small> struct PixelType { typedef uint16_t type; };
+template <> struct PixelType<true> { typedef uint8_t type; };
+
+/*
+  Geometría del búfer de imagen (páginas de 8 filas, como el SSD1306).
+
+  coord es el tipo con signo de las posiciones que pueden quedar fuera de la imagen (sprites, extremos
+  de las columnas de pared): int8_t en la pantalla de 128x64, como hasta ahora, e int16_t en las
+  mayores. pixel es el tipo sin signo de los índices de columna y fila, que debe poder contener
+  el ancho para que los bucles terminen. La geometría de la pantalla (OnScreen) dibuja en display_buf
+  y zbuffer; las demás tienen sus propios búferes (FrameTarget en display.h) y solo se usan en el host.
+*/
+template <uint16_t Width, uint16_t Height, uint16_t RenderHeight, bool OnScreen = false>
+struct FrameGeometry {
+  static constexpr uint16_t width = Width;
+  static constexpr uint16_t height = Height;
+  static constexpr uint16_t render_height = RenderHeight;
+  static constexpr uint16_t pages = Height / 8;
+  static constexpr bool on_screen = OnScreen;
+
+  typedef typename CoordType<(Width <= 128 && Height <= 64)>::type coord;
+  typedef typename PixelType<(Width < 256 && Height < 256)>::type pixel;
+
+  static_assert(Height % 8 == 0 && RenderHeight % 8 == 0, "la imagen se escribe por páginas de 8 filas");
+  static_assert(RenderHeight <= Height, "el área del raycaster debe caber en la imagen");
+};
+
+typedef FrameGeometry<SCREEN_WIDTH, SCREEN_HEIGHT, RENDER_HEIGHT, true> ScreenGeometry;
+
+template <class Geometry, uint8_t ResDivider, uint8_t ZResDivider, uint8_t MaxRenderDepth, uint8_t DistanceMultiplier, bool PageWrites>
+struct RenderConfig {
+  typedef Geometry geometry;
+  typedef typename Geometry::coord coord;
+  typedef typename Geometry::pixel pixel;
+
+  static constexpr uint16_t width = Geometry::width;
+  static constexpr uint16_t height = Geometry::height;
+  static constexpr uint16_t render_height = Geometry::render_height;
+
+  static constexpr uint8_t res_divider = ResDivider;                  // Ancho en píxeles de cada rayo
+  static constexpr uint8_t z_res_divider = ZResDivider;               // Columnas por entrada del z-buffer
+  static constexpr uint8_t max_render_depth = MaxRenderDepth;         // Celdas que recorre cada rayo
+  static constexpr uint8_t distance_multiplier = DistanceMultiplier;  // Escala de las distancias en uint8_t
+  static constexpr bool page_writes = PageWrites;                     // Escribe bytes de página en el búfer
+
+  static_assert(!Geometry::on_screen || ZResDivider >= Z_RES_DIVIDER, "zbuffer tiene ZBUFFER_SIZE entradas");
+  static_assert(Geometry::on_screen || PageWrites, "drawPixel() de la biblioteca solo dibuja en la pantalla");
+  static_assert(Geometry::width % ResDivider == 0, "RES_DIVIDER debe dividir el ancho de la imagen");
+};
+
+#ifdef OPTIMIZE_SSD1306
+typedef RenderConfig<ScreenGeometry, RES_DIVIDER, Z_RES_DIVIDER, MAX_RENDER_DEPTH, DISTANCE_MULTIPLIER, true> RenderDefault;
+#else
+typedef RenderConfig<ScreenGeometry, RES_DIVIDER, Z_RES_DIVIDER, MAX_RENDER_DEPTH, DISTANCE_MULTIPLIER, false> RenderDefault;
+#endif
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef _render_pool_h
+#define _render_pool_h
+
+/*
+  Grupo de hilos del renderizado en el ordenador (solo HOST_BUILD).
+
+  run() reparte una tarea entre los hilos: la función recibe el índice del hilo (0 es el hilo que
+  llama) y run() no vuelve hasta que todos han terminado. Los hilos se crean una vez y esperan
+  entre cuadros, así que el coste por cuadro es solo el de despertarlos.
+*/
+// Las macros min y max de Arduino rompen las cabeceras de la biblioteca estándar
+#pragma push_macro("min")
+#pragma push_macro("max")
+#undef min
+#undef max
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#pragma pop_macro("min")
+#pragma pop_macro("max")
+
+class RenderPool {
+  public:
+    explicit RenderPool(uint8_t threads) : threads(threads) {
+      for (uint8_t i = 1; i < threads; i++) {
+        workers.push_back(std::thread(&RenderPool::work, this, i));
+      }
+    }
+
+    ~RenderPool() {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+      }
+      wake.notify_all();
+      for (std::thread &worker : workers) worker.join();
+    }
+
+    uint8_t size() const {
+      return threads;
+    }
+
+    // Núcleos del ordenador según la biblioteca estándar (al menos 1)
+    static uint8_t hardwareThreads() {
+      unsigned int cores = std::thread::hardware_concurrency();
+      return cores == 0 ? 1 : cores > 255 ? 255 : cores;
+    }
+
+    void run(const std::function<void(uint8_t)> &fn) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = &fn;
+        pending = threads - 1;
+        generation++;
+      }
+      wake.notify_all();
+
+      fn(0);
+
+      std::unique_lock<std::mutex> lock(mutex);
+      done.wait(lock, [this] { return pending == 0; });
+      task = NULL;
+    }
+
+  private:
+    void work(uint8_t index) {
+      uint32_t seen = 0;
+
+      while (true) {
+        const std::function<void(uint8_t)> *fn;
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          wake.wait(lock, [&] { return stop || generation != seen; });
+          if (stop) return;
+          seen = generation;
+          fn = task;
+        }
+
+        (*fn)(index);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pending == 0) done.notify_one();
+      }
+    }
+
+    uint8_t threads;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(uint8_t)> *task = NULL;
+    uint8_t pending = 0;
+    uint32_t generation = 0;
+    bool stop = false;
+};
+
+#endif
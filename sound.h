@@ -11,25 +11,79 @@
 #define _sound_h
 
 #include <avr/pgmspace.h>
+#include <util/atomic.h>
 #include "constants.h"
 
-constexpr uint8_t GET_KEY_SND_LEN = 90;
-constexpr uint8_t SHOOT_SND_LEN = 27;
-constexpr uint8_t shoot_snd[] PROGMEM = { 0x10, 0x10 , 0x10 , 0x6e , 0x2a , 0x20 , 0x28 , 0x28 , 0x9b , 0x28 , 0x20 , 0x20 , 0x21 , 0x57 , 0x20 , 0x20 , 0x20 , 0x67 , 0x20 , 0x20 , 0x29 , 0x20 , 0x73 , 0x20 , 0x20 , 0x20 , 0x89};
-constexpr uint8_t get_key_snd[] PROGMEM = {0x24, 0x24, 0x24 , 0x24 , 0x24 , 0x24 , 0x24 , 0x24 , 0x24 , 0x24 , 0x24 , 0x24 , 0x24 , 0x24 , 0x24 , 0x24 , 0x24 , 0x24 , 0x24 , 0x24 , 0x24 , 0x24 , 0x24 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x37 , 0x37 , 0x37 , 0x37 , 0x37 , 0x37 , 0x37 , 0x37 , 0x37 , 0x37 , 0x20 , 0x20 , 0x20 , 0x20 , 0x37 , 0x37 , 0x37 , 0x37 , 0x37 , 0x37 , 0x37 , 0x37 , 0x37 , 0x37 , 0x20 , 0x20 , 0x20 , 0x20 , 0x37 , 0x37 , 0x37 , 0x37 , 0x37 , 0x37 , 0x37 , 0x37 , 0x37 , 0x37 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x19 , 0x19 , 0x19 , 0x19 , 0x19 , 0x19 , 0x19 , 0x19 , 0x19 , 0x19 , 0x19 , 0x19 , 0x19 , 0x19 , 0x19 , 0x19 };
-constexpr uint8_t HIT_WALL_SND_LEN = 8;
-constexpr uint8_t hit_wall_snd[] PROGMEM = { 0x83 , 0x83 , 0x82 , 0x8e , 0x8a , 0x89 , 0x86 , 0x84};
-constexpr uint8_t WALK1_SND_LEN = 3;
-constexpr uint8_t walk1_snd[] PROGMEM = { 0x8f, 0x8e, 0x8e};
-constexpr uint8_t WALK2_SND_LEN = 3;
-constexpr uint8_t walk2_snd[] PROGMEM = { 0x84, 0x87, 0x84};
-constexpr uint8_t MEDKIT_SND_LEN = 69;
-constexpr uint8_t medkit_snd[] PROGMEM = {0x55 , 0x20 , 0x3a , 0x3a , 0x3a , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x33 , 0x33 , 0x33 , 0x33 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x26 , 0x26 , 0x26 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x16 , 0x16 , 0x16 , 0x16 , 0x16 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x16 , 0x16 , 0x16 , 0x16 , 0x16 , 0x16 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x15 , 0x15 , 0x15 , 0x15 , 0x15 , 0x15, 0x15};
-
-uint8_t idx = 0;
-bool sound = false;
-uint16_t snd_ptr = 0;
-uint8_t snd_len = 0;
+// Control de los tramos de los efectos (formato de tools/sound_tables.py)
+#define SND_END           0x00     // Fin del efecto
+#define SND_LITERAL       0x80     // Siguen count muestras distintas; si no, se repite la siguiente muestra
+#define SND_COUNT_MASK    0x7F
+
+// Efectos comprimidos (generados por tools/sound_tables.py desde assets/sounds.txt, no editar)
+
+// 27 muestras
+constexpr uint8_t shoot_snd[] PROGMEM = {
+  0x03, 0x10, 0x8b, 0x6e, 0x2a, 0x20, 0x28, 0x28, 0x9b, 0x28, 0x20, 0x20, 0x21, 0x57, 0x03, 0x20,
+  0x86, 0x67, 0x20, 0x20, 0x29, 0x20, 0x73, 0x03, 0x20, 0x01, 0x89, 0x00,
+};
+
+// 90 muestras
+constexpr uint8_t get_key_snd[] PROGMEM = {
+  0x17, 0x24, 0x07, 0x20, 0x0a, 0x37, 0x04, 0x20, 0x0a, 0x37, 0x04, 0x20, 0x0a, 0x37, 0x06, 0x20,
+  0x10, 0x19, 0x00,
+};
+
+// 8 muestras
+constexpr uint8_t hit_wall_snd[] PROGMEM = {
+  0x02, 0x83, 0x86, 0x82, 0x8e, 0x8a, 0x89, 0x86, 0x84, 0x00,
+};
+
+// 3 muestras
+constexpr uint8_t walk1_snd[] PROGMEM = {
+  0x01, 0x8f, 0x02, 0x8e, 0x00,
+};
+
+// 3 muestras
+constexpr uint8_t walk2_snd[] PROGMEM = {
+  0x83, 0x84, 0x87, 0x84, 0x00,
+};
+
+// 71 muestras
+constexpr uint8_t medkit_snd[] PROGMEM = {
+  0x82, 0x55, 0x20, 0x03, 0x3a, 0x07, 0x20, 0x04, 0x33, 0x09, 0x20, 0x03, 0x26, 0x07, 0x20, 0x05,
+  0x16, 0x09, 0x20, 0x06, 0x16, 0x09, 0x20, 0x07, 0x15, 0x00,
+};
+
+// 33 muestras
+constexpr uint8_t enemy_alert_snd[] PROGMEM = {
+  0x03, 0x70, 0x03, 0x78, 0x03, 0x80, 0x03, 0x88, 0x04, 0x90, 0x03, 0x88, 0x04, 0x98, 0x04, 0xa0,
+  0x06, 0xb0, 0x00,
+};
+
+// 46 muestras
+constexpr uint8_t enemy_death_snd[] PROGMEM = {
+  0x02, 0x40, 0x02, 0x48, 0x02, 0x50, 0x02, 0x58, 0x03, 0x60, 0x01, 0x00, 0x03, 0x70, 0x03, 0x80,
+  0x01, 0x00, 0x04, 0x90, 0x04, 0xa0, 0x05, 0xb0, 0x06, 0xc0, 0x08, 0xd8, 0x00,
+};
+
+// 32 muestras
+constexpr uint8_t door_snd[] PROGMEM = {
+  0x02, 0x9b, 0x02, 0x96, 0x02, 0x9b, 0x02, 0x96, 0x02, 0x9b, 0x02, 0x96, 0x02, 0x9b, 0x02, 0x96,
+  0x02, 0x9b, 0x02, 0x96, 0x02, 0x9b, 0x02, 0x96, 0x04, 0xa4, 0x01, 0x00, 0x03, 0xc8, 0x00,
+};
+
+// 20 muestras
+constexpr uint8_t fireball_snd[] PROGMEM = {
+  0x89, 0x50, 0x48, 0x40, 0x38, 0x30, 0x2c, 0x28, 0x24, 0x22, 0x02, 0x20, 0x02, 0x1e, 0x03, 0x1c,
+  0x04, 0x1a, 0x00,
+};
+// Fin de los efectos generados
+
+// Estado del efecto en curso, compartido con el ISR del timer 2
+volatile bool sound = false;
+const uint8_t *volatile snd_ptr = NULL; // Siguiente byte del efecto
+volatile uint8_t snd_count = 0;         // Muestras que quedan del tramo actual
+volatile bool snd_literal = false;      // El tramo actual lee una muestra por tick
 
 void sound_init() {
   pinMode(SOUND_PIN, OUTPUT);
@@ -40,10 +94,16 @@ void sound_init() {
   TIMSK2 = (1 << OCIE2A);
 }
 
-void playSound(const uint8_t* snd, uint8_t len) {
-  snd_ptr = reinterpret_cast<uint16_t>(snd);
-  snd_len = len;
-  sound = true;
+void playSound(const uint8_t* snd) {
+#ifdef HOST_BUILD
+  if (host_headless) return;
+#endif
+  // snd_ptr ocupa dos bytes: con las interrupciones desactivadas el ISR no ve un efecto a medias
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    snd_ptr = snd;
+    snd_count = 0;
+    sound = true;
+  }
 }
 
 // Set the frequency that we will get on pin OCR1A
@@ -80,17 +140,41 @@ void off() {
   TCCR1A = 0;
 }
 
+// Programa el timer 1 con una muestra (0 es silencio)
+void playSample(uint8_t sample) {
+  if (sample == 0) {
+    off();
+    return;
+  }
+  setFrequency(1192030 / (60 * (uint16_t) sample)); // 1193181
+}
+
+// Descomprime el efecto sobre la marcha: cada tick lee a lo sumo el control de un tramo y una
+// muestra, y en las repeticiones deja sonar el timer 1 sin reprogramarlo. Las interrupciones están
+// desactivadas dentro del ISR, así que trabaja con copias locales del estado volátil
 ISR(TIMER2_COMPA_vect) {
-  if (sound) {
-    if (idx++ < snd_len) {
-      uint16_t freq = 1192030 / (60 * (uint16_t) pgm_read_byte(snd_ptr + idx)); // 1193181
-      setFrequency(freq);
-    } else {
-      idx = 0;
+  if (!sound) return;
+
+  const uint8_t *ptr = snd_ptr;
+  uint8_t count = snd_count;
+  bool literal = snd_literal;
+
+  if (count == 0) {
+    uint8_t control = pgm_read_byte(ptr++);
+    if (control == SND_END) {
       off();
       sound = false;
+      return;
     }
+    count = control & SND_COUNT_MASK;
+    literal = control & SND_LITERAL;
+    snd_literal = literal;
+    if (!literal) playSample(pgm_read_byte(ptr++));
   }
+
+  if (literal) playSample(pgm_read_byte(ptr++));
+  snd_ptr = ptr;
+  snd_count = count - 1;
 }
 
 #endif
\ No newline at end of file
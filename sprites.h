@@ -3,19 +3,44 @@
 
 #include <avr/pgmspace.h>
 #include <stdint.h>
+#include "constants.h"
 
-#define bmp_font_width   24  // in bytes
-#define bmp_font_height  6
+// Fuente de 4x6 almacenada por columnas (un byte por columna, bit 0 = fila superior),
+// con el mismo orden que las páginas del SSD1306. Los glifos siguen el orden de CHAR_MAP.
 #define CHAR_MAP         " 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ.,-_(){}[]#"
 #define CHAR_WIDTH       4
 #define CHAR_HEIGHT      6
 const static uint8_t bmp_font[] PROGMEM = {
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x80, 0x00,
-  0x06, 0x26, 0x69, 0xf6, 0xf6, 0x66, 0xe6, 0xef, 0xf6, 0x92, 0x19, 0x89, 0x96, 0xe6, 0xe6, 0xe9, 0x99, 0x99, 0xf0, 0x00, 0x02, 0x41, 0x83, 0xcf,
-  0x09, 0x29, 0x99, 0x88, 0x19, 0x99, 0x99, 0x98, 0x88, 0x92, 0x1a, 0x8f, 0xd9, 0x99, 0x98, 0x49, 0x99, 0x99, 0x10, 0x00, 0x04, 0x27, 0xe5, 0x6f,
-  0x09, 0x22, 0x2f, 0xee, 0x16, 0x7f, 0xe8, 0x9e, 0xe8, 0xf2, 0x1c, 0x89, 0xb9, 0xe9, 0xe6, 0x49, 0x99, 0x66, 0x60, 0x06, 0x04, 0x27, 0xe7, 0xef,
-  0x09, 0x24, 0x91, 0x19, 0x19, 0x19, 0x99, 0x98, 0x89, 0x92, 0x9a, 0x89, 0x99, 0x8b, 0x91, 0x49, 0x6f, 0x96, 0x80, 0x20, 0x04, 0x21, 0x87, 0xef,
-  0x06, 0x7f, 0x61, 0xe6, 0x16, 0x69, 0xe6, 0xef, 0x86, 0x92, 0x69, 0xf9, 0x96, 0x87, 0x9e, 0x46, 0x69, 0x96, 0xf4, 0x40, 0xf2, 0x41, 0x80, 0xe0,
+  0x00, 0x00, 0x00, 0x00, 0x1c, 0x22, 0x22, 0x1c, 0x00, 0x20, 0x3e, 0x20, 0x24, 0x32, 0x2a, 0x24,
+  0x14, 0x22, 0x2a, 0x14, 0x0e, 0x08, 0x08, 0x3e, 0x2e, 0x2a, 0x2a, 0x12, 0x1c, 0x2a, 0x2a, 0x10,
+  0x02, 0x02, 0x02, 0x3e, 0x14, 0x2a, 0x2a, 0x14, 0x04, 0x2a, 0x2a, 0x1c, 0x3c, 0x0a, 0x0a, 0x3c,
+  0x3e, 0x2a, 0x2a, 0x14, 0x1c, 0x22, 0x22, 0x14, 0x3e, 0x22, 0x22, 0x1c, 0x3e, 0x2a, 0x2a, 0x22,
+  0x3e, 0x0a, 0x0a, 0x02, 0x1c, 0x22, 0x22, 0x10, 0x3e, 0x08, 0x08, 0x3e, 0x00, 0x00, 0x3e, 0x00,
+  0x10, 0x20, 0x20, 0x1e, 0x3e, 0x08, 0x14, 0x22, 0x3e, 0x20, 0x20, 0x20, 0x3e, 0x04, 0x04, 0x3e,
+  0x3e, 0x04, 0x08, 0x3e, 0x1c, 0x22, 0x22, 0x1c, 0x3e, 0x0a, 0x0a, 0x04, 0x1c, 0x22, 0x32, 0x3c,
+  0x3e, 0x0a, 0x0a, 0x34, 0x24, 0x2a, 0x2a, 0x10, 0x02, 0x3e, 0x02, 0x00, 0x1e, 0x20, 0x20, 0x1e,
+  0x0e, 0x30, 0x30, 0x0e, 0x3e, 0x10, 0x10, 0x3e, 0x36, 0x08, 0x08, 0x36, 0x06, 0x38, 0x38, 0x06,
+  0x32, 0x2a, 0x2a, 0x26, 0x00, 0x20, 0x00, 0x00, 0x00, 0x20, 0x10, 0x00, 0x00, 0x08, 0x08, 0x00,
+  0x20, 0x20, 0x20, 0x20, 0x00, 0x1c, 0x22, 0x00, 0x00, 0x22, 0x1c, 0x00, 0x00, 0x0c, 0x0c, 0x3f,
+  0x3f, 0x0c, 0x0c, 0x00, 0x00, 0x1c, 0x1a, 0x1e, 0x3a, 0x3e, 0x3c, 0x00, 0x1e, 0x1e, 0x1e, 0x1e,
+};
+
+// Índice del glifo de un carácter en CHAR_MAP (0 = espacio si no existe), evaluado en compilación
+constexpr uint8_t charIndex(char ch, uint8_t i = 0) {
+  return CHAR_MAP[i] == '\0' ? 0 : (CHAR_MAP[i] == ch ? i : charIndex(ch, i + 1));
+}
+
+// Tabla ASCII -> glifo para los caracteres imprimibles (0x20 - 0x7F)
+#define CHAR_FIRST       ' '
+#define CHAR_COUNT       96
+#define CHAR_INDEX_ROW(c) \
+  charIndex(c),      charIndex(c + 1),  charIndex(c + 2),  charIndex(c + 3),  \
+  charIndex(c + 4),  charIndex(c + 5),  charIndex(c + 6),  charIndex(c + 7),  \
+  charIndex(c + 8),  charIndex(c + 9),  charIndex(c + 10), charIndex(c + 11), \
+  charIndex(c + 12), charIndex(c + 13), charIndex(c + 14), charIndex(c + 15)
+constexpr uint8_t char_index[CHAR_COUNT] PROGMEM = {
+  CHAR_INDEX_ROW(0x20), CHAR_INDEX_ROW(0x30), CHAR_INDEX_ROW(0x40),
+  CHAR_INDEX_ROW(0x50), CHAR_INDEX_ROW(0x60), CHAR_INDEX_ROW(0x70),
 };
 
 #define BMP_LOGO_WIDTH  72
@@ -70,576 +95,299 @@ const static uint8_t bmp_logo_bits[] PROGMEM = {
   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c,
 };
 
+// Arma y fogonazo almacenados por columnas en formato de página ((alto + 7) / 8 bytes por columna,
+// bit 0 = fila superior) para dibujarlos con drawOverlay()
 #define BMP_GUN_WIDTH   32
 #define BMP_GUN_HEIGHT  32
 const static uint8_t bmp_gun_bits[] PROGMEM = {
-  0x00, 0x00, 0x20, 0x00,
-  0x00, 0x00, 0xd8, 0x00,
-  0x00, 0x01, 0xc4, 0x00,
-  0x00, 0x02, 0x04, 0x00,
-  0x00, 0x02, 0x02, 0x00,
-  0x00, 0x02, 0xea, 0x00,
-  0x00, 0x04, 0xd1, 0x00,
-  0x00, 0x09, 0x88, 0x80,
-  0x00, 0x19, 0x00, 0x00,
-  0x00, 0x0d, 0xc2, 0x80,
-  0x00, 0x29, 0x81, 0xc0,
-  0x00, 0x0b, 0xa2, 0x20,
-  0x00, 0x31, 0x40, 0x40,
-  0x00, 0x23, 0x00, 0xc0,
-  0x00, 0x13, 0x00, 0x40,
-  0x00, 0x72, 0x02, 0x00,
-  0x00, 0x49, 0x00, 0x40,
-  0x01, 0xe0, 0xa8, 0x20,
-  0x07, 0xf1, 0x00, 0x30,
-  0x0b, 0xb9, 0xe0, 0xe8,
-  0x07, 0x5c, 0x03, 0xfc,
-  0x07, 0xef, 0xff, 0xee,
-  0x07, 0x75, 0x7f, 0xd2,
-  0x1b, 0xbb, 0xff, 0xb2,
-  0x11, 0x57, 0x7d, 0x64,
-  0x32, 0xaf, 0xff, 0xe8,
-  0x13, 0x5f, 0x75, 0xd0,
-  0x33, 0xff, 0xfb, 0x98,
-  0x17, 0xd7, 0xe5, 0x00,
-  0x1b, 0x8f, 0xb2, 0x30,
-  0x03, 0x7d, 0x58, 0x10,
-  0x6f, 0xbf, 0xec, 0x20,
+  0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x80,
+  0x00, 0x00, 0x00, 0x8a,
+  0x00, 0x00, 0x80, 0x3f,
+  0x00, 0x00, 0x88, 0xa0,
+  0x00, 0x00, 0x74, 0x90,
+  0x00, 0x00, 0xfc, 0xfe,
+  0x00, 0x00, 0xfe, 0xfd,
+  0x00, 0x00, 0xae, 0xba,
+  0x00, 0x80, 0x77, 0x5d,
+  0x00, 0xb4, 0xee, 0xca,
+  0x00, 0xd1, 0xdc, 0xdd,
+  0x80, 0x0f, 0xb9, 0xee,
+  0x40, 0x02, 0x70, 0xff,
+  0x38, 0xe8, 0xa0, 0xbf,
+  0x84, 0x7f, 0xed, 0xff,
+  0xe6, 0x0e, 0xaa, 0xba,
+  0x66, 0x12, 0xe8, 0xdf,
+  0x21, 0x08, 0xea, 0xbf,
+  0x42, 0x00, 0xe0, 0x6f,
+  0xa2, 0x00, 0xe2, 0xcb,
+  0x0c, 0x00, 0xe0, 0x97,
+  0x30, 0x8a, 0xf0, 0x2a,
+  0x40, 0x04, 0xf0, 0x1f,
+  0x80, 0x26, 0xf8, 0x0e,
+  0x00, 0x74, 0x79, 0x07,
+  0x00, 0x08, 0xbe, 0xa3,
+  0x00, 0x00, 0xd4, 0x6c,
+  0x00, 0x00, 0x38, 0x0a,
+  0x00, 0x00, 0x30, 0x01,
+  0x00, 0x00, 0xe0, 0x00,
+  0x00, 0x00, 0x00, 0x00,
 };
 const static uint8_t bmp_gun_mask[] PROGMEM = {
-  0x00, 0x00, 0x70, 0x00,
-  0x00, 0x01, 0xfc, 0x00,
-  0x00, 0x03, 0xfe, 0x00,
-  0x00, 0x07, 0xfe, 0x00,
-  0x00, 0x07, 0xff, 0x00,
-  0x00, 0x07, 0xff, 0x00,
-  0x00, 0x0f, 0xff, 0x80,
-  0x00, 0x1f, 0xff, 0xc0,
-  0x00, 0x3f, 0xff, 0x80,
-  0x00, 0x3f, 0xff, 0xc0,
-  0x00, 0x7f, 0xff, 0xe0,
-  0x00, 0x7f, 0xff, 0xf0,
-  0x00, 0x7f, 0xff, 0xe0,
-  0x00, 0x7f, 0xff, 0xe0,
-  0x00, 0x7f, 0xff, 0xe0,
-  0x00, 0xff, 0xff, 0xc0,
-  0x00, 0xff, 0xff, 0xe0,
-  0x03, 0xff, 0xff, 0xf0,
-  0x0f, 0xff, 0xff, 0xf8,
-  0x1f, 0xff, 0xff, 0xfc,
-  0x1f, 0xff, 0xff, 0xfe,
-  0x1f, 0xff, 0xff, 0xff,
-  0x1f, 0xff, 0xff, 0xff,
-  0x3f, 0xff, 0xff, 0xff,
-  0x3f, 0xff, 0xff, 0xfe,
-  0x7f, 0xff, 0xff, 0xfc,
-  0x7f, 0xff, 0xff, 0xf8,
-  0x7f, 0xff, 0xff, 0xfc,
-  0x7f, 0xff, 0xff, 0xf8,
-  0x7f, 0xff, 0xff, 0xf8,
-  0x7f, 0xff, 0xff, 0xf8,
-  0xff, 0xff, 0xff, 0xf0,
+  0x00, 0x00, 0x00, 0x80,
+  0x00, 0x00, 0x00, 0xfe,
+  0x00, 0x00, 0x80, 0xff,
+  0x00, 0x00, 0xf8, 0xff,
+  0x00, 0x00, 0xfc, 0xff,
+  0x00, 0x00, 0xfc, 0xff,
+  0x00, 0x00, 0xfe, 0xff,
+  0x00, 0x00, 0xfe, 0xff,
+  0x00, 0x80, 0xff, 0xff,
+  0x00, 0xfc, 0xff, 0xff,
+  0x00, 0xff, 0xff, 0xff,
+  0x80, 0xff, 0xff, 0xff,
+  0xc0, 0xff, 0xff, 0xff,
+  0xf8, 0xff, 0xff, 0xff,
+  0xfc, 0xff, 0xff, 0xff,
+  0xfe, 0xff, 0xff, 0xff,
+  0xfe, 0xff, 0xff, 0xff,
+  0xff, 0xff, 0xff, 0xff,
+  0xff, 0xff, 0xff, 0xff,
+  0xff, 0xff, 0xff, 0xff,
+  0xfe, 0xff, 0xff, 0xff,
+  0xfe, 0xff, 0xff, 0xff,
+  0xfc, 0xff, 0xff, 0xff,
+  0xf0, 0xff, 0xff, 0xff,
+  0xc0, 0xff, 0xff, 0xff,
+  0x80, 0xfe, 0xff, 0xff,
+  0x00, 0x7c, 0xff, 0xff,
+  0x00, 0x08, 0xfe, 0xff,
+  0x00, 0x00, 0xfc, 0x7f,
+  0x00, 0x00, 0xf8, 0x0b,
+  0x00, 0x00, 0xf0, 0x01,
+  0x00, 0x00, 0xe0, 0x00,
 };
 
 #define BMP_FIRE_WIDTH  24
 #define BMP_FIRE_HEIGHT 20
 const static uint8_t bmp_fire_bits[] PROGMEM = {
-  0x00, 0x00, 0x00,
-  0x00, 0x18, 0x00,
-  0x00, 0x0c, 0x00,
-  0x02, 0x77, 0x00,
-  0x01, 0x67, 0x00,
-  0x01, 0xe5, 0x80,
-  0x01, 0xe3, 0xc0,
-  0x02, 0xa2, 0xc0,
-  0x07, 0x82, 0xe0,
-  0x1f, 0x41, 0xf9,
-  0x9d, 0x80, 0x7c,
-  0x3e, 0x00, 0x5e,
-  0x76, 0x00, 0x6a,
-  0x38, 0x00, 0x36,
-  0x2f, 0x80, 0x5c,
-  0x36, 0x00, 0x7e,
-  0x3f, 0x00, 0x58,
-  0x10, 0x00, 0x3c,
-  0x88, 0x00, 0x00,
-  0x00, 0x00, 0x00,
+  0x00, 0x04, 0x04,
+  0x00, 0x10, 0x00,
+  0x00, 0xf8, 0x01,
+  0x00, 0xbe, 0x03,
+  0x00, 0x6e, 0x05,
+  0x00, 0xdf, 0x01,
+  0x88, 0xdb, 0x01,
+  0x70, 0x47, 0x01,
+  0xe0, 0x45, 0x00,
+  0x78, 0x02, 0x00,
+  0xf8, 0x00, 0x00,
+  0x0a, 0x00, 0x00,
+  0x06, 0x00, 0x00,
+  0x3c, 0x00, 0x00,
+  0xd8, 0x01, 0x00,
+  0x78, 0x02, 0x00,
+  0xe0, 0x03, 0x00,
+  0xc0, 0xdf, 0x01,
+  0x00, 0xb7, 0x02,
+  0x00, 0xee, 0x03,
+  0x00, 0xde, 0x03,
+  0x00, 0xec, 0x02,
+  0x00, 0xb8, 0x00,
+  0x00, 0x02, 0x00,
 };
 
-#define BMP_IMP_WIDTH   32
-#define BMP_IMP_HEIGHT  32
-#define BMP_IMP_COUNT   5
-const static uint8_t bmp_imp_bits[] PROGMEM = {
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x01, 0x80, 0x00,
-  0x00, 0x02, 0x80, 0x00,
-  0x00, 0x07, 0x40, 0x00,
-  0x00, 0x02, 0x80, 0x00,
-  0x00, 0x01, 0x00, 0x00,
-  0x01, 0x0f, 0xb3, 0x00,
-  0x00, 0xd0, 0x4e, 0x00,
-  0x00, 0x79, 0x8c, 0x00,
-  0x00, 0x1c, 0x19, 0x00,
-  0x01, 0x8a, 0x20, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x03, 0x00,
-  0x02, 0x00, 0x00, 0x00,
-  0x03, 0x02, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x40,
-  0x02, 0x08, 0x00, 0x80,
-  0x00, 0x00, 0x01, 0x00,
-  0x01, 0x8e, 0x30, 0x00,
-  0x00, 0x04, 0x10, 0x00,
-  0x00, 0x0c, 0x20, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x10, 0x00,
-  0x00, 0x06, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x20, 0x00,
-  0x00, 0x01, 0x00, 0x00,
-  0x00, 0x02, 0x20, 0x00,
-  0x00, 0x05, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x01, 0x80, 0x00,
-  0x00, 0x02, 0x40, 0x00,
-  0x00, 0x03, 0xe0, 0x00,
-  0x00, 0x04, 0x00, 0x00,
-  0x00, 0x01, 0xa1, 0x80,
-  0x01, 0x80, 0x13, 0x00,
-  0x00, 0xf3, 0x8a, 0x00,
-  0x00, 0x09, 0x94, 0x00,
-  0x00, 0x88, 0x38, 0x80,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x02, 0x23, 0x00,
-  0x00, 0x00, 0x00, 0x40,
-  0x01, 0x80, 0x00, 0x80,
-  0x00, 0x00, 0x01, 0x00,
-  0x00, 0xe2, 0x80, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x0c, 0x20, 0x00,
-  0x00, 0x04, 0x30, 0x00,
-  0x00, 0x02, 0x20, 0x00,
-  0x00, 0x00, 0x40, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x01, 0x00, 0x00,
-  0x00, 0x02, 0x20, 0x00,
-  0x00, 0x06, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x02, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0xa0, 0x00,
-  0x00, 0x00, 0x48, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x04, 0x00,
-  0x00, 0x00, 0x0a, 0x00,
-  0x00, 0x00, 0x1f, 0x00,
-  0x00, 0x02, 0x2a, 0x80,
-  0x00, 0x01, 0x05, 0x00,
-  0x00, 0x01, 0xae, 0x20,
-  0x00, 0x01, 0x24, 0x40,
-  0x00, 0x02, 0xac, 0x80,
-  0x00, 0x02, 0x86, 0x00,
-  0x00, 0x03, 0x20, 0x20,
-  0x00, 0x04, 0x30, 0x40,
-  0x00, 0x0c, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x40,
-  0x00, 0x00, 0x20, 0x20,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x08, 0x20,
-  0x00, 0x01, 0x00, 0x00,
-  0x00, 0x02, 0x1a, 0x00,
-  0x00, 0x00, 0x1c, 0x00,
-  0x00, 0x00, 0x38, 0x00,
-  0x00, 0x04, 0x00, 0x00,
-  0x00, 0x02, 0x98, 0x00,
-  0x00, 0x00, 0x18, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x36, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x20, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x04, 0x00,
-  0x00, 0x00, 0x0a, 0x00,
-  0x00, 0x00, 0x08, 0x40,
-  0x00, 0x00, 0x00, 0x80,
-  0x00, 0x01, 0xd6, 0x80,
-  0x00, 0x02, 0xbf, 0x80,
-  0x00, 0x06, 0x61, 0xa0,
-  0x00, 0x0c, 0xe8, 0x80,
-  0x00, 0x0c, 0x10, 0x00,
-  0x00, 0x1a, 0x22, 0x00,
-  0x00, 0x12, 0x40, 0x00,
-  0x00, 0x06, 0x0c, 0x00,
-  0x00, 0x04, 0x0d, 0x00,
-  0x00, 0x3a, 0x03, 0x00,
-  0x00, 0x10, 0x02, 0x00,
-  0x00, 0x60, 0x0a, 0x00,
-  0x00, 0x50, 0x04, 0x00,
-  0x00, 0x20, 0x03, 0x00,
-  0x00, 0x00, 0x04, 0x00,
-  0x00, 0x20, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x20, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x40, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x02, 0x24, 0x00,
-  0x00, 0x01, 0x08, 0x00,
-  0x00, 0x01, 0x18, 0x00,
-  0x00, 0x01, 0x41, 0x40,
-  0x02, 0x33, 0xb6, 0x80,
-  0x01, 0x9c, 0x04, 0x00,
-  0x08, 0xfa, 0x02, 0x08,
-  0x05, 0x00, 0x01, 0x0c,
-  0x27, 0x83, 0xa2, 0x2a,
-  0x00, 0x04, 0x00, 0x00,
-  0x02, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-};
-const static uint8_t bmp_imp_mask[] PROGMEM = {
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x03, 0xc0, 0x00,
-  0x00, 0x03, 0xc0, 0x00,
-  0x00, 0x07, 0xe0, 0x00,
-  0x00, 0x07, 0xe0, 0x00,
-  0x00, 0x03, 0xe0, 0x00,
-  0x01, 0x07, 0xf1, 0x80,
-  0x00, 0xdf, 0xfe, 0x00,
-  0x00, 0x3f, 0xfe, 0x00,
-  0x00, 0x7f, 0xff, 0x00,
-  0x01, 0xff, 0xff, 0x80,
-  0x00, 0xff, 0xff, 0x80,
-  0x01, 0xff, 0xff, 0x80,
-  0x03, 0xcf, 0xf1, 0xc0,
-  0x01, 0xc7, 0xf1, 0xc0,
-  0x01, 0x87, 0xf1, 0xc0,
-  0x03, 0x0f, 0xf9, 0x80,
-  0x03, 0x0f, 0xfb, 0x80,
-  0x01, 0x8f, 0xff, 0x80,
-  0x03, 0x9f, 0x79, 0x00,
-  0x00, 0x1f, 0x7c, 0x00,
-  0x00, 0x0f, 0x78, 0x00,
-  0x00, 0x0f, 0x78, 0x00,
-  0x00, 0x07, 0x30, 0x00,
-  0x00, 0x07, 0x38, 0x00,
-  0x00, 0x07, 0x30, 0x00,
-  0x00, 0x07, 0x30, 0x00,
-  0x00, 0x03, 0x78, 0x00,
-  0x00, 0x07, 0x30, 0x00,
-  0x00, 0x0f, 0x80, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x03, 0xc0, 0x00,
-  0x00, 0x07, 0xc0, 0x00,
-  0x00, 0x07, 0xe0, 0x00,
-  0x00, 0x07, 0xc0, 0x00,
-  0x01, 0x07, 0xe1, 0x00,
-  0x00, 0x8f, 0xfa, 0x00,
-  0x00, 0xff, 0xfe, 0x00,
-  0x00, 0x3f, 0xfe, 0x00,
-  0x01, 0x7f, 0xff, 0x80,
-  0x00, 0xff, 0xff, 0x00,
-  0x01, 0xff, 0xff, 0x80,
-  0x03, 0xcf, 0xfb, 0xc0,
-  0x03, 0x87, 0xf1, 0xc0,
-  0x03, 0xcf, 0xf3, 0xc0,
-  0x01, 0xcf, 0xf1, 0x80,
-  0x00, 0xcf, 0xf1, 0x00,
-  0x00, 0x0f, 0xfb, 0x80,
-  0x00, 0x1e, 0x78, 0x00,
-  0x00, 0x0e, 0x78, 0x00,
-  0x00, 0x1e, 0x78, 0x00,
-  0x00, 0x0f, 0x70, 0x00,
-  0x00, 0x0f, 0x78, 0x00,
-  0x00, 0x07, 0x70, 0x00,
-  0x00, 0x07, 0x70, 0x00,
-  0x00, 0x07, 0x38, 0x00,
-  0x00, 0x03, 0x30, 0x00,
-  0x00, 0x03, 0x20, 0x00,
-  0x00, 0x07, 0x30, 0x00,
-  0x00, 0x05, 0x70, 0x00,
-  0x00, 0x00, 0x78, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x0e, 0x00,
-  0x00, 0x00, 0x1f, 0x00,
-  0x00, 0x00, 0x1f, 0x00,
-  0x00, 0x03, 0x3f, 0x80,
-  0x00, 0x01, 0x3f, 0x00,
-  0x00, 0x01, 0xff, 0x30,
-  0x00, 0x03, 0xff, 0xc0,
-  0x00, 0x03, 0xff, 0xc0,
-  0x00, 0x03, 0xff, 0x80,
-  0x00, 0x07, 0xff, 0xe0,
-  0x00, 0x07, 0xff, 0xc0,
-  0x00, 0x05, 0xff, 0xe0,
-  0x00, 0x00, 0xfc, 0xe0,
-  0x00, 0x01, 0xfc, 0xe0,
-  0x00, 0x01, 0xfc, 0x70,
-  0x00, 0x03, 0xfc, 0x38,
-  0x00, 0x03, 0xfe, 0x70,
-  0x00, 0x07, 0xfc, 0x00,
-  0x00, 0x07, 0x9e, 0x00,
-  0x00, 0x0f, 0xbc, 0x00,
-  0x00, 0x0f, 0x3e, 0x00,
-  0x00, 0x07, 0x9c, 0x00,
-  0x00, 0x03, 0x9c, 0x00,
-  0x00, 0x03, 0xb8, 0x00,
-  0x00, 0x03, 0x98, 0x00,
-  0x00, 0x01, 0x98, 0x00,
-  0x00, 0x02, 0x1c, 0x00,
-  0x00, 0x00, 0x36, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x20, 0x00,
-  0x00, 0x00, 0x38, 0x00,
-  0x00, 0x00, 0x1f, 0x00,
-  0x00, 0x00, 0x1f, 0x40,
-  0x00, 0x00, 0x3e, 0x80,
-  0x00, 0x01, 0xff, 0x80,
-  0x00, 0x03, 0xff, 0x80,
-  0x00, 0x07, 0xff, 0xe0,
-  0x00, 0x0e, 0xff, 0xc0,
-  0x00, 0x0c, 0xff, 0x80,
-  0x00, 0x1f, 0xfe, 0x00,
-  0x00, 0x13, 0xfc, 0x00,
-  0x00, 0x07, 0xfe, 0x00,
-  0x00, 0x1f, 0xff, 0x00,
-  0x00, 0x3f, 0x9f, 0x00,
-  0x00, 0x3e, 0x0f, 0x00,
-  0x00, 0x7c, 0x0f, 0x00,
-  0x00, 0x78, 0x0f, 0x00,
-  0x00, 0x78, 0x07, 0x80,
-  0x00, 0x78, 0x07, 0x40,
-  0x00, 0x38, 0x07, 0x80,
-  0x00, 0x30, 0x07, 0x00,
-  0x00, 0x30, 0x01, 0x00,
-  0x01, 0xf0, 0x00, 0x00,
-  0x01, 0xb0, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00,
-  0x00, 0x01, 0x1c, 0x00,
-  0x00, 0x01, 0x3e, 0x00,
-  0x00, 0x03, 0xff, 0x00,
-  0x00, 0x0f, 0xff, 0xe0,
-  0x01, 0x3f, 0xff, 0xc0,
-  0x01, 0xff, 0xff, 0xc0,
-  0x19, 0xff, 0xff, 0xe8,
-  0x7f, 0xff, 0xff, 0xfe,
-  0x3f, 0xff, 0xff, 0xfe,
-  0x1f, 0xc2, 0x07, 0xe0,
-  0x1f, 0x00, 0x01, 0xe0,
-  0x0e, 0x00, 0x00, 0x40,
-  0x00, 0x00, 0x00, 0x00,
+// Sprites por columnas (generados por tools/sprite_tables.py desde assets/, no editar)
+
+#define BMP_IMP_WIDTH        32
+#define BMP_IMP_HEIGHT       32
+#define BMP_IMP_COUNT        5
+const static uint16_t bmp_imp_frames[] PROGMEM = { 0, 156, 312, 453, 586 };
+const static uint8_t bmp_imp_spans[] PROGMEM = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0e, 0x81, 0x02, 0x81, 0x41, 0x01, 0x41, 0x00, 0x07, 0x81,
+  0x03, 0x81, 0x01, 0xc8, 0x22, 0x00, 0x08, 0x81, 0x02, 0x81, 0x45, 0x02, 0x81, 0x41, 0x00, 0x08,
+  0x81, 0x01, 0x46, 0x00, 0x09, 0x81, 0x44, 0x00, 0x08, 0x83, 0x43, 0x06, 0x42, 0x00, 0x08, 0xc7,
+  0x70, 0x02, 0xc7, 0xa8, 0x06, 0x41, 0x00, 0x04, 0x81, 0x41, 0x01, 0xd5, 0x90, 0x0e, 0x20, 0x01,
+  0x41, 0x81, 0x00, 0x02, 0xdd, 0x74, 0x44, 0x41, 0x10, 0x00, 0x02, 0xdd, 0xad, 0x00, 0x00, 0x28,
+  0x00, 0x02, 0xc8, 0xd5, 0x4a, 0x0a, 0x41, 0x00, 0x02, 0xc7, 0x22, 0x4f, 0x04, 0x41, 0x00, 0x04,
+  0x42, 0xd8, 0x44, 0x05, 0x05, 0x00, 0x07, 0xd7, 0x90, 0x0c, 0x40, 0x00, 0x08, 0x83, 0x43, 0x03,
+  0x47, 0x01, 0x41, 0x02, 0x41, 0x00, 0x08, 0x82, 0x44, 0x05, 0x41, 0x01, 0x41, 0x00, 0x08, 0xc6,
+  0x84, 0x04, 0x42, 0x00, 0x07, 0x81, 0x02, 0xcb, 0x90, 0x80, 0x00, 0x07, 0x41, 0x03, 0x46, 0x81,
+  0x42, 0x00, 0x0e, 0x42, 0x81, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x0c, 0x43, 0x00, 0x05, 0x41, 0x03, 0x41, 0x01, 0xc5, 0x20, 0x00, 0x06, 0x82, 0x02,
+  0xc7, 0x14, 0x00, 0x07, 0x81, 0x01, 0x44, 0x01, 0xc3, 0x40, 0x00, 0x07, 0x81, 0x44, 0x00, 0x07,
+  0x81, 0x44, 0x06, 0x41, 0x01, 0x41, 0x00, 0x06, 0xc7, 0x30, 0x01, 0x43, 0x81, 0x45, 0x00, 0x02,
+  0xd8, 0x20, 0x01, 0x82, 0x02, 0x42, 0x00, 0x01, 0xdc, 0x62, 0x22, 0x23, 0x20, 0x00, 0x01, 0xc8,
+  0xab, 0x49, 0x03, 0x41, 0x81, 0x47, 0x00, 0x01, 0x81, 0xd0, 0x56, 0x04, 0x00, 0x01, 0xd8, 0x60,
+  0x00, 0x10, 0x04, 0x41, 0x81, 0x00, 0x03, 0x81, 0x01, 0xda, 0x8a, 0x0e, 0x20, 0x80, 0x00, 0x06,
+  0xcd, 0xb0, 0x08, 0x48, 0x01, 0x43, 0x00, 0x06, 0xc7, 0x50, 0x04, 0x44, 0x01, 0x41, 0x02, 0x41,
+  0x04, 0x81, 0x00, 0x07, 0xc5, 0x40, 0x00, 0x06, 0xc7, 0xc4, 0x01, 0x41, 0x02, 0x41, 0x00, 0x05,
+  0x81, 0x03, 0x41, 0xc8, 0x48, 0x00, 0x09, 0x81, 0x01, 0xc5, 0x20, 0x01, 0x41, 0x00, 0x0c, 0x81,
+  0x42, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x15, 0x42, 0x00, 0x0b, 0x41, 0x82, 0x05, 0xc5, 0x10, 0x00, 0x05, 0x81,
+  0x02, 0xc5, 0x70, 0x04, 0x42, 0xc8, 0x88, 0x01, 0x41, 0x00, 0x05, 0x41, 0xc8, 0xe4, 0x01, 0x43,
+  0x81, 0x49, 0x00, 0x07, 0xc4, 0xb0, 0x4b, 0x01, 0x81, 0x44, 0x00, 0x07, 0x4d, 0x00, 0x05, 0xcf,
+  0xbb, 0x20, 0x01, 0x81, 0x41, 0x02, 0x41, 0x03, 0x81, 0x00, 0x03, 0xdb, 0x40, 0x40, 0xec, 0x20,
+  0x00, 0x02, 0xd7, 0x75, 0x01, 0x76, 0x44, 0x00, 0x02, 0xd7, 0xaf, 0x80, 0x20, 0x03, 0x41, 0x81,
+  0x00, 0x02, 0xcc, 0x74, 0x80, 0x04, 0x41, 0x01, 0x41, 0x01, 0x41, 0x06, 0x81, 0x00, 0x03, 0xc4,
+  0x50, 0x47, 0x00, 0x05, 0x81, 0x02, 0xc8, 0x40, 0x00, 0x08, 0x81, 0x41, 0x01, 0xc6, 0x50, 0x01,
+  0x41, 0x00, 0x07, 0x81, 0x03, 0x81, 0x01, 0xc6, 0x28, 0x00, 0x07, 0x41, 0x08, 0x43, 0x00, 0x11,
+  0x41, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1c, 0x42, 0x00, 0x1c,
+  0x42, 0x00, 0x15, 0x82, 0x42, 0x03, 0x41, 0x00, 0x13, 0xcb, 0xaa, 0x80, 0x00, 0x0f, 0x82, 0x01,
+  0xc5, 0x68, 0x47, 0x00, 0x0d, 0x83, 0x02, 0xc8, 0x40, 0x00, 0x0c, 0x83, 0x41, 0x01, 0x82, 0x43,
+  0x00, 0x0b, 0x82, 0x41, 0x01, 0xc6, 0xe8, 0x00, 0x0a, 0x81, 0x42, 0x02, 0x45, 0x00, 0x0a, 0x82,
+  0xc8, 0x40, 0x00, 0x0a, 0x81, 0xc8, 0x64, 0x00, 0x05, 0x42, 0x02, 0x42, 0xc8, 0xe8, 0x00, 0x06,
+  0xce, 0x0c, 0x80, 0x00, 0x06, 0x41, 0xd0, 0xca, 0x32, 0x00, 0x07, 0xd4, 0x18, 0x31, 0x40, 0x00,
+  0x07, 0x81, 0xc8, 0x31, 0x01, 0x42, 0xc8, 0xe8, 0x00, 0x07, 0x42, 0x01, 0xc5, 0x60, 0x03, 0x82,
+  0xc8, 0x10, 0x00, 0x09, 0x85, 0x41, 0x08, 0x41, 0x01, 0x41, 0x00, 0x08, 0x81, 0x03, 0x42, 0x0a,
+  0x41, 0x00, 0x0c, 0x81, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1a, 0x41, 0x00, 0x1a, 0x41,
+  0x81, 0x00, 0x19, 0x45, 0x00, 0x19, 0x81, 0x45, 0x00, 0x1a, 0x82, 0x43, 0x00, 0x1a, 0xc5, 0x50,
+  0x00, 0x17, 0xc7, 0x58, 0x00, 0x18, 0xc5, 0xd0, 0x00, 0x18, 0xc5, 0x40, 0x00, 0x17, 0xc5, 0xa0,
+  0x00, 0x17, 0x83, 0x42, 0x00, 0x16, 0xc6, 0x30, 0x00, 0x16, 0xc6, 0x20, 0x00, 0x15, 0xc8, 0x2a,
+  0x00, 0x13, 0x41, 0xc8, 0xf1, 0x00, 0x15, 0xc7, 0x22, 0x00, 0x15, 0xc7, 0x40, 0x00, 0x14, 0xc8,
+  0x11, 0x00, 0x13, 0x41, 0xc8, 0x50, 0x00, 0x13, 0x41, 0x82, 0x46, 0x00, 0x13, 0xc6, 0x8c, 0x44,
+  0x00, 0x14, 0x41, 0xc8, 0x2a, 0x00, 0x15, 0x41, 0xc8, 0x88, 0x00, 0x16, 0xc8, 0x40, 0x00, 0x16,
+  0x81, 0x48, 0x00, 0x16, 0x41, 0x02, 0xc5, 0x20, 0x00, 0x1a, 0x42, 0x00, 0x19, 0x83, 0x00, 0x1a,
+  0x81, 0x41, 0x00, 0x1a, 0x41, 0x81, 0x00, 0x00,
 };
 
-#define BMP_FIREBALL_WIDTH 16
-#define BMP_FIREBALL_HEIGHT 16
-const static uint8_t bmp_fireball_bits[] PROGMEM = {
-  0x00, 0x00,
-  0x01, 0x40,
-  0x0a, 0xb0,
-  0x0e, 0xd0,
-  0x00, 0x68,
-  0x53, 0xb4,
-  0x0f, 0x48,
-  0x27, 0x78,
-  0x17, 0xa8,
-  0x27, 0xf0,
-  0x21, 0xd6,
-  0x02, 0xf8,
-  0x20, 0x48,
-  0x06, 0x20,
-  0x01, 0x00,
-  0x00, 0x00,
+#define BMP_FIREBALL_WIDTH   16
+#define BMP_FIREBALL_HEIGHT  16
+#define BMP_FIREBALL_COUNT   1
+const static uint16_t bmp_fireball_frames[] PROGMEM = { 0 };
+const static uint8_t bmp_fireball_spans[] PROGMEM = {
+  0x07, 0x45, 0x00, 0x04, 0xc8, 0x40, 0x00, 0x02, 0x41, 0x01, 0x41, 0xc8, 0x2d, 0x00, 0x41, 0x01,
+  0xc7, 0x12, 0x45, 0x00, 0xc7, 0x32, 0x46, 0x00, 0xcf, 0x13, 0xc4, 0x00, 0xcf, 0x37, 0xd4, 0x00,
+  0xd0, 0x47, 0xe2, 0x00, 0x01, 0xcf, 0x69, 0xe0, 0x00, 0xd0, 0x5b, 0x78, 0x00, 0x01, 0xcf, 0x5b,
+  0xa8, 0x00, 0x01, 0xce, 0x6a, 0xe0, 0x00, 0x02, 0xcc, 0x2e, 0x60, 0x00, 0x03, 0x42, 0xc8, 0x84,
+  0x01, 0x41, 0x00, 0x07, 0xc6, 0x10, 0x00, 0x04, 0x41, 0x01, 0x41, 0x01, 0x42, 0x00,
 };
-const static uint8_t bmp_fireball_mask[] PROGMEM = {
-  0x1f, 0x40,
-  0x0f, 0xf0,
-  0x3f, 0xf8,
-  0x1f, 0xfc,
-  0x7f, 0xfd,
-  0x7f, 0xfc,
-  0x7f, 0xfd,
-  0xff, 0xfe,
-  0xff, 0xff,
-  0xff, 0xff,
-  0xff, 0xfe,
-  0xff, 0xfe,
-  0x3f, 0xfe,
-  0x17, 0xf8,
-  0x07, 0xf4,
-  0x01, 0xe0,
+
+#define BMP_ITEMS_WIDTH      16
+#define BMP_ITEMS_HEIGHT     16
+#define BMP_ITEMS_COUNT      2
+const static uint16_t bmp_items_frames[] PROGMEM = { 0, 61 };
+const static uint8_t bmp_items_spans[] PROGMEM = {
+  0x00, 0x02, 0xcd, 0xea, 0xa8, 0x00, 0x01, 0xcf, 0xfa, 0xaa, 0x00, 0xd0, 0xfe, 0xfe, 0x00, 0xd0,
+  0xf7, 0x7f, 0x00, 0x88, 0xc8, 0x67, 0x00, 0x8b, 0x42, 0x83, 0x00, 0x89, 0x47, 0x00, 0x89, 0x46,
+  0x81, 0x00, 0x8b, 0x42, 0x83, 0x00, 0x88, 0xc8, 0x67, 0x00, 0xd0, 0xf7, 0x7f, 0x00, 0x87, 0x41,
+  0x88, 0x00, 0x01, 0x85, 0x41, 0x89, 0x00, 0x02, 0xcd, 0xed, 0x58, 0x00, 0x00, 0x00, 0x00, 0x07,
+  0xc5, 0xe8, 0x00, 0x06, 0xc6, 0xb8, 0x00, 0x05, 0xc7, 0x8e, 0x00, 0x05, 0xc8, 0xdd, 0x00, 0x05,
+  0x87, 0x41, 0x81, 0x00, 0x05, 0x81, 0xc8, 0x9e, 0x00, 0x05, 0x81, 0xc8, 0x9d, 0x00, 0x05, 0x88,
+  0x41, 0x00, 0x05, 0x81, 0xc8, 0xdd, 0x00, 0x05, 0x81, 0xc8, 0x9e, 0x00, 0x05, 0x81, 0xc8, 0xdd,
+  0x00, 0x05, 0x88, 0x00, 0x00, 0x00,
 };
+// Fin de los sprites generados
+
+// Texturas de pared de 32x32 almacenadas por columnas: 4 bytes por columna, con el bit 0 del
+// primer byte en la fila superior, para muestrear una columna completa en drawTexturedVLine()
+#define BMP_TEXTURE_SIZE  32
+#define BMP_TEXTURE_BYTES (BMP_TEXTURE_SIZE * BMP_TEXTURE_SIZE / 8)
 
 #define BMP_DOOR_WIDTH    32
 #define BMP_DOOR_HEIGHT   32
 const static uint8_t bmp_door_bits[] PROGMEM = {
-  0xff, 0xff, 0xff, 0xff,
-  0xb2, 0xbd, 0xcd, 0x5b,
-  0x9a, 0xf4, 0x6d, 0x71,
-  0xff, 0xff, 0xff, 0xff,
-  0x00, 0x00, 0x00, 0x00,
-  0xbf, 0xff, 0xff, 0xfd,
-  0x3f, 0x00, 0xfe, 0xfc,
-  0x3e, 0x00, 0xc6, 0xfc,
-  0xbc, 0xaa, 0xfe, 0xbd,
-  0x39, 0x54, 0xc6, 0xbc,
-  0x32, 0x8e, 0xfe, 0xac,
-  0xb5, 0xfe, 0xc6, 0xad,
-  0x3f, 0xe0, 0xfe, 0xac,
-  0x31, 0xe0, 0xc6, 0xac,
-  0xb3, 0xf4, 0xfe, 0xad,
-  0x3f, 0xe8, 0xc6, 0xac,
-  0x3c, 0xf4, 0xd6, 0xac,
-  0xb8, 0xff, 0xfe, 0xad,
-  0x34, 0xc7, 0xfe, 0xfc,
-  0x38, 0xd6, 0x0e, 0x0c,
-  0xb0, 0xd6, 0x4e, 0x0d,
-  0x3f, 0xd6, 0xaf, 0x5c,
-  0x30, 0x47, 0xff, 0xac,
-  0xb7, 0x57, 0xff, 0xfd,
-  0x3f, 0xc6, 0x0e, 0x0c,
-  0x35, 0x56, 0x40, 0x4c,
-  0xb5, 0x46, 0xaa, 0xad,
-  0x35, 0x56, 0x55, 0x4c,
-  0xff, 0xff, 0xff, 0xff,
-  0xb0, 0x1f, 0xf8, 0x0d,
-  0xd9, 0x30, 0x0c, 0x9b,
-  0xff, 0xe0, 0x07, 0xff,
+  0x2f, 0x49, 0x92, 0xf4,
+  0x09, 0x00, 0x00, 0xd0,
+  0xeb, 0xff, 0xff, 0xbf,
+  0xef, 0xff, 0xff, 0xff,
+  0xed, 0x93, 0x2b, 0xd1,
+  0xe9, 0x99, 0xa5, 0x9f,
+  0xef, 0xd4, 0xa0, 0x91,
+  0x69, 0xfa, 0xa0, 0xdf,
+  0x2f, 0xfd, 0x3f, 0x91,
+  0x2d, 0xfa, 0xff, 0x9f,
+  0x2f, 0xf9, 0x03, 0xd0,
+  0x2f, 0x4a, 0xbb, 0x7a,
+  0x2b, 0x8d, 0x02, 0x30,
+  0x2f, 0x4e, 0xff, 0x3f,
+  0x29, 0x0d, 0xfe, 0x3f,
+  0x2b, 0x00, 0xc6, 0x30,
+  0xeb, 0xff, 0xe7, 0x34,
+  0xef, 0xff, 0xd7, 0x3a,
+  0x6d, 0x55, 0xe6, 0x34,
+  0x69, 0x55, 0xc7, 0x38,
+  0x6f, 0x55, 0xfe, 0x75,
+  0xef, 0xff, 0xff, 0xd9,
+  0xe9, 0xff, 0xff, 0x95,
+  0x2f, 0x00, 0xe0, 0x98,
+  0xe9, 0xff, 0xc7, 0xd4,
+  0xef, 0x00, 0xa4, 0x9a,
+  0xed, 0xff, 0xc7, 0x94,
+  0xef, 0x03, 0xa4, 0xd0,
+  0xeb, 0xff, 0xff, 0xff,
+  0xe9, 0xff, 0xff, 0xbf,
+  0x0b, 0x00, 0x00, 0xd0,
+  0x2f, 0x49, 0x92, 0xf4,
 };
 
-#define BMP_ITEMS_WIDTH   16
-#define BMP_ITEMS_HEIGHT  16
-#define BMP_ITEMS_COUNT   2
-const static uint8_t bmp_items_bits[] PROGMEM = {
-  0x1f, 0xf8,
-  0x3f, 0xfc,
-  0x7f, 0xfe,
-  0x7f, 0xfe,
-  0x77, 0xee,
-  0x3f, 0xfc,
-  0x5f, 0xfa,
-  0x2f, 0xf6,
-  0x53, 0xcc,
-  0x3e, 0x7e,
-  0x5e, 0x7c,
-  0x38, 0x1e,
-  0x58, 0x1c,
-  0x3e, 0x7e,
-  0x5e, 0x7e,
-  0x2e, 0xfc,
-  0x00, 0x00,
-  0x00, 0x00,
-  0x00, 0x00,
-  0x00, 0x00,
-  0x00, 0x00,
-  0x0f, 0xfc,
-  0x17, 0xfc,
-  0x22, 0x6c,
-  0x36, 0x44,
-  0x3f, 0xfc,
-  0x1f, 0xfc,
-  0x2b, 0xfc,
-  0x05, 0x54,
-  0x02, 0xa8,
-  0x00, 0x00,
-  0x00, 0x00,
-};
-const static uint8_t bmp_items_mask[] PROGMEM = {
-  0x1f, 0xf8,
-  0x3f, 0xfc,
-  0x7f, 0xfe,
-  0x7f, 0xfe,
-  0x7f, 0xfe,
-  0x7f, 0xfe,
-  0x7f, 0xfe,
-  0x7f, 0xfe,
-  0x7f, 0xfe,
-  0x7f, 0xfe,
-  0x7f, 0xfe,
-  0x7f, 0xfe,
-  0x7f, 0xfe,
-  0x7f, 0xfe,
-  0x7f, 0xfe,
-  0x3f, 0xfc,
-  0x00, 0x00,
-  0x00, 0x00,
-  0x00, 0x00,
-  0x00, 0x00,
-  0x00, 0x00,
-  0x0f, 0xfc,
-  0x1f, 0xfc,
-  0x3f, 0xfc,
-  0x3f, 0xfc,
-  0x3f, 0xfc,
-  0x3f, 0xfc,
-  0x3f, 0xfc,
-  0x07, 0xfc,
-  0x03, 0xf8,
-  0x00, 0x00,
-  0x00, 0x00,
+// Ladrillo y panel metálico
+#define BMP_WALL_COUNT    2
+const static uint8_t bmp_wall_bits[] PROGMEM = {
+  0x3e, 0x7f, 0x7f, 0x1f,
+  0x7f, 0x7b, 0x3f, 0x7f,
+  0x7f, 0x1f, 0x7f, 0x7f,
+  0x3f, 0x7e, 0x7f, 0x3f,
+  0x7f, 0x7f, 0x3d, 0x7f,
+  0x7d, 0x3f, 0x7f, 0x7f,
+  0x3f, 0x7d, 0x7f, 0x3f,
+  0x7f, 0x00, 0x3f, 0x00,
+  0x7f, 0x3f, 0x7f, 0x6f,
+  0x3f, 0x7f, 0x7f, 0x3f,
+  0x7f, 0x77, 0x3f, 0x7f,
+  0x5f, 0x3f, 0x7f, 0x7f,
+  0x3f, 0x7f, 0x7f, 0x37,
+  0x7f, 0x7f, 0x3f, 0x7e,
+  0x77, 0x3f, 0x7f, 0x7f,
+  0x00, 0x7f, 0x00, 0x3f,
+  0x7f, 0x7f, 0x3f, 0x7d,
+  0x7f, 0x3f, 0x6f, 0x7f,
+  0x3f, 0x7f, 0x7f, 0x3f,
+  0x6f, 0x7f, 0x3f, 0x7f,
+  0x7f, 0x3f, 0x77, 0x7f,
+  0x3f, 0x7f, 0x7f, 0x3f,
+  0x7f, 0x7f, 0x3f, 0x7f,
+  0x7f, 0x00, 0x7f, 0x00,
+  0x3f, 0x7f, 0x7f, 0x3f,
+  0x7f, 0x7f, 0x1f, 0x7f,
+  0x7f, 0x3f, 0x7f, 0x7b,
+  0x3f, 0x7f, 0x7b, 0x3f,
+  0x7f, 0x7f, 0x3f, 0x7f,
+  0x7e, 0x3f, 0x7f, 0x5f,
+  0x3f, 0x7b, 0x7f, 0x3f,
+  0x00, 0x5f, 0x00, 0x7f,
+  0x00, 0x00, 0x01, 0x00,
+  0xfe, 0x7f, 0xfe, 0x7f,
+  0xfe, 0x7f, 0xff, 0x7f,
+  0xf6, 0x6f, 0xf6, 0x6f,
+  0xfe, 0x7f, 0xff, 0x7f,
+  0xfe, 0x7f, 0xfe, 0x7f,
+  0xbe, 0x7a, 0xbf, 0x7a,
+  0x5e, 0x7d, 0x5e, 0x7d,
+  0xbe, 0x7a, 0xbf, 0x7a,
+  0x5e, 0x7d, 0x5e, 0x7d,
+  0xbe, 0x7a, 0xbf, 0x7a,
+  0x5e, 0x7d, 0x5e, 0x7d,
+  0xbe, 0x7a, 0xbf, 0x7a,
+  0x5e, 0x7d, 0x5e, 0x7d,
+  0xbe, 0x7a, 0xbf, 0x7a,
+  0x5e, 0x7d, 0x5e, 0x7d,
+  0xbe, 0x7a, 0xbf, 0x7a,
+  0x5e, 0x7d, 0x5e, 0x7d,
+  0xbe, 0x7a, 0xbf, 0x7a,
+  0x5e, 0x7d, 0x5e, 0x7d,
+  0xbe, 0x7a, 0xbf, 0x7a,
+  0x5e, 0x7d, 0x5e, 0x7d,
+  0xbe, 0x7a, 0xbf, 0x7a,
+  0x5e, 0x7d, 0x5e, 0x7d,
+  0xbe, 0x7a, 0xbf, 0x7a,
+  0x5e, 0x7d, 0x5e, 0x7d,
+  0xfe, 0x7f, 0xff, 0x7f,
+  0xfe, 0x7f, 0xfe, 0x7f,
+  0xf6, 0x6f, 0xf7, 0x6f,
+  0xfe, 0x7f, 0xfe, 0x7f,
+  0xfe, 0x7f, 0xff, 0x7f,
+  0x00, 0x00, 0x01, 0x00,
 };
 
 // Gradient for lighting.
@@ -716,4 +464,57 @@ const static uint8_t gradient[] PROGMEM = {
   0xff, 0xff,
 };
 
+// El mismo gradiente por columnas en formato de página (bit 0 = fila superior de la página).
+// El patrón se repite cada 8 filas, así que una página completa se rellena con un solo byte por columna.
+#define GRADIENT_PAGE_WIDTH 16
+constexpr uint8_t gradient_page[] PROGMEM = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x22, 0x00, 0x88, 0x00, 0x22, 0x00, 0xa8, 0x00, 0x22, 0x00, 0x88, 0x00, 0x22, 0x00, 0xa8, 0x00,
+  0xaa, 0x00, 0xaa, 0x04, 0xaa, 0x00, 0xaa, 0x40, 0xaa, 0x00, 0xaa, 0x04, 0xaa, 0x00, 0xaa, 0x40,
+  0xaa, 0x15, 0xaa, 0x44, 0xaa, 0x55, 0xaa, 0x44, 0xaa, 0x55, 0xaa, 0x44, 0xaa, 0x55, 0xaa, 0x44,
+  0xaa, 0x55, 0xaa, 0xdd, 0xaa, 0x55, 0xaa, 0xdd, 0xaa, 0x75, 0xaa, 0xdd, 0xaa, 0x55, 0xaa, 0xdd,
+  0xaa, 0x7f, 0xaa, 0xff, 0xaa, 0x77, 0xaa, 0xff, 0xaa, 0x7f, 0xaa, 0xff, 0xaa, 0xf7, 0xaa, 0xff,
+  0xee, 0xff, 0xba, 0xff, 0xee, 0xff, 0xbb, 0xff, 0xee, 0xff, 0xba, 0xff, 0xee, 0xff, 0xab, 0xff,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
+#ifdef FLOOR_CEILING
+// Distancia (en celdas) del suelo o techo visible en la fila y, con el horizonte en el centro de la vista
+constexpr double floorRowDistance(uint8_t y) {
+  return (RENDER_HEIGHT / 2) / ((y < RENDER_HEIGHT / 2 ? RENDER_HEIGHT / 2 - y : y + 1 - RENDER_HEIGHT / 2) - 0.5);
+}
+
+// Intensidad del gradiente de cada fila: se apaga con la distancia, como las paredes
+constexpr uint8_t floorRowIntensity(uint8_t y) {
+  return floorRowDistance(y) >= MAX_RENDER_DEPTH ? 0 : uint8_t(
+    (y < RENDER_HEIGHT / 2 ? CEILING_INTENSITY : FLOOR_INTENSITY)
+    * (MAX_RENDER_DEPTH - floorRowDistance(y)) / MAX_RENDER_DEPTH + 0.5
+  );
+}
+
+// Byte de página con el patrón de cada fila para la columna x del patrón
+constexpr uint8_t floorCeilingByte(uint8_t page, uint8_t x, uint8_t bit = 0) {
+  return bit == 8 ? 0
+    : (gradient_page[floorRowIntensity(page * 8 + bit) * GRADIENT_PAGE_WIDTH + x] & (1 << bit))
+      | floorCeilingByte(page, x, bit + 1);
+}
+
+#define FLOOR_CEILING_ROW(p) \
+  floorCeilingByte(p, 0), floorCeilingByte(p, 1), floorCeilingByte(p, 2), floorCeilingByte(p, 3), \
+  floorCeilingByte(p, 4), floorCeilingByte(p, 5), floorCeilingByte(p, 6), floorCeilingByte(p, 7), \
+  floorCeilingByte(p, 8), floorCeilingByte(p, 9), floorCeilingByte(p, 10), floorCeilingByte(p, 11), \
+  floorCeilingByte(p, 12), floorCeilingByte(p, 13), floorCeilingByte(p, 14), floorCeilingByte(p, 15)
+
+// Suelo y techo precalculados por página: GRADIENT_PAGE_WIDTH bytes por página de la vista
+constexpr uint8_t floor_ceiling_page[RENDER_HEIGHT / 8 * GRADIENT_PAGE_WIDTH] PROGMEM = {
+  FLOOR_CEILING_ROW(0),
+  FLOOR_CEILING_ROW(1),
+  FLOOR_CEILING_ROW(2),
+  FLOOR_CEILING_ROW(3),
+  FLOOR_CEILING_ROW(4),
+  FLOOR_CEILING_ROW(5),
+  FLOOR_CEILING_ROW(6)
+};
+#endif
+
 #endif
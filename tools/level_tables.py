@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+"""
+Genera en level.h las tablas de sto_level_1 que no se pueden calcular con constexpr en un tiempo de
+compilación razonable (las demás salen de level_compiler.h), a partir del mapa ASCII de Level1Map.
+
+sto_level_1_distance (EMPTY_SPACE_SKIP): para cada celda vacía de sto_level_1 (suelo, inicio del
+jugador o salida), la distancia por eje hasta el bloque más cercano que el raycaster tiene que leer
+(paredes, puertas, enemigos y objetos). Es el rectángulo vacío centrado en la celda de mayor área,
+con radios rx, ry de 1 a 4 celdas: todas las celdas con |dx| < rx y |dy| < ry están vacías.
+Se guarda como ((rx - 1) << 2) | (ry - 1); 0 indica que no hay nada que saltar (bloques y celdas
+vacías sin rectángulo mayor que ellas mismas).
+
+Se usa un radio por eje y no la distancia de Chebyshev porque el nivel es casi todo pasillos de una
+o dos celdas de ancho, donde la distancia a la pared más cercana es siempre 1 y no permitiría saltar.
+
+Esta tabla usa el mismo empaquetado que el nivel (4 bits por celda, filas invertidas). El script también simula los rayos desde todas las celdas vacías e imprime
+los pasos del DDA (iteraciones del bucle de castRay()) y las lecturas de PROGMEM por rayo con y sin el salto de espacio vacío.
+
+Uso: python3 tools/level_tables.py [ruta/a/level.h] [--check]
+  --check  no modifica level.h; termina con error si las tablas no están actualizadas
+"""
+import math
+import os
+import re
+import sys
+
+LEVEL_WIDTH = 64
+LEVEL_HEIGHT = 57
+MAX_RENDER_DEPTH = 12
+MAX_RADIUS = 4
+
+# Bloques que el raycaster ignora: suelo, inicio del jugador y salida (types.h)
+EMPTY_BLOCKS = (0x0, 0x1, 0x7)
+
+BEGIN = '// Tablas derivadas de sto_level_1 (generadas por tools/level_tables.py, no editar)\n'
+END = '// Fin de las tablas generadas\n'
+
+
+# Leyenda de types.h
+LEGEND = {'.': 0x0, '#': 0xF, 'P': 0x1, 'E': 0x2, 'D': 0x4, 'L': 0x5, 'X': 0x7, 'M': 0x8, 'K': 0x9}
+
+
+def read_level(source):
+    """Empaqueta el mapa de Level1Map igual que level_compiler.h."""
+    match = re.search(r'struct Level1Map \{.*?cells\[\] =(.*?);', source, re.S)
+    cells = ''.join(re.findall(r'"([^"]*)"', match.group(1)))
+    assert len(cells) == LEVEL_WIDTH * LEVEL_HEIGHT
+    return [LEGEND[cells[i]] << 4 | LEGEND[cells[i + 1]] for i in range(0, len(cells), 2)]
+
+
+def get_nibble(table, x, y):
+    # Igual que getBlockAt(): filas invertidas, nibble alto en las columnas pares
+    byte = table[((LEVEL_HEIGHT - 1 - y) * LEVEL_WIDTH + x) // 2]
+    return byte >> 4 if x % 2 == 0 else byte & 0xF
+
+
+def build_distance(level):
+    empty = [[get_nibble(level, x, y) in EMPTY_BLOCKS for x in range(LEVEL_WIDTH)] for y in range(LEVEL_HEIGHT)]
+
+    def is_empty_box(x, y, rx, ry):
+        return all(0 <= bx < LEVEL_WIDTH and 0 <= by < LEVEL_HEIGHT and empty[by][bx]
+                   for by in range(y - ry + 1, y + ry) for bx in range(x - rx + 1, x + rx))
+
+    distance = [[0] * LEVEL_WIDTH for _ in range(LEVEL_HEIGHT)]
+    for y in range(LEVEL_HEIGHT):
+        for x in range(LEVEL_WIDTH):
+            if not empty[y][x]:
+                continue
+            # Mayor área; a igual área, el rectángulo más cuadrado
+            boxes = [(rx * ry, min(rx, ry), rx, ry)
+                     for rx in range(1, MAX_RADIUS + 1) for ry in range(1, MAX_RADIUS + 1)
+                     if is_empty_box(x, y, rx, ry)]
+            _, _, rx, ry = max(boxes)
+            distance[y][x] = (rx - 1) << 2 | (ry - 1)
+    return distance
+
+
+def pack(distance):
+    packed = [0] * (LEVEL_WIDTH * LEVEL_HEIGHT // 2)
+    for y in range(LEVEL_HEIGHT):
+        for x in range(LEVEL_WIDTH):
+            i = ((LEVEL_HEIGHT - 1 - y) * LEVEL_WIDTH + x) // 2
+            packed[i] |= distance[y][x] << 4 if x % 2 == 0 else distance[y][x]
+    return packed
+
+
+def format_array(declaration, values, per_line):
+    lines = [declaration + ' = {\n']
+    for row in range(0, len(values), per_line):
+        lines.append('  ' + ''.join('0x%02X, ' % v for v in values[row:row + per_line]) + '\n')
+    lines.append('};\n')
+    return ''.join(lines)
+
+
+def format_tables(packed):
+    return (BEGIN
+            + '\n// Radios por eje del rectángulo vacío centrado en cada celda (EMPTY_SPACE_SKIP)\n'
+            + format_array('const static uint8_t sto_level_1_distance[LEVEL_SIZE] PROGMEM', packed, LEVEL_WIDTH // 2)
+            + END)
+
+
+def cast(level, distance, px, py, angle, skip):
+    """DDA de castRay() atravesando puertas y entidades; devuelve las lecturas de PROGMEM y los pasos."""
+    ray_x, ray_y = math.cos(angle), math.sin(angle)
+    map_x, map_y = int(px), int(py)
+    delta_x = abs(1 / ray_x) if ray_x else 1e30
+    delta_y = abs(1 / ray_y) if ray_y else 1e30
+    step_x = -1 if ray_x < 0 else 1
+    step_y = -1 if ray_y < 0 else 1
+    side_x = (px - map_x if ray_x < 0 else map_x + 1 - px) * delta_x
+    side_y = (py - map_y if ray_y < 0 else map_y + 1 - py) * delta_y
+    reads = 0
+    steps = 0
+    depth = 0
+
+    while depth < MAX_RENDER_DEPTH:
+        steps += 1
+        if side_x < side_y:
+            side_x += delta_x
+            map_x += step_x
+        else:
+            side_y += delta_y
+            map_y += step_y
+
+        if skip:
+            reads += 1
+            box = distance[map_y][map_x]
+            if box:
+                # Salto a la última celda del rectángulo que cruza el rayo, como en castRay()
+                inside_x, inside_y = box >> 2, box & 3
+                exit_x = side_x + inside_x * delta_x
+                exit_y = side_y + inside_y * delta_y
+                if exit_x < exit_y:
+                    jump_x = inside_x
+                    jump_y = min(inside_y, int((exit_x - side_y) / delta_y) + 1 if side_y <= exit_x else 0)
+                else:
+                    jump_y = inside_y
+                    jump_x = min(inside_x, math.ceil((exit_y - side_x) / delta_x) if side_x < exit_y else 0)
+                map_x += step_x * jump_x
+                side_x += jump_x * delta_x
+                map_y += step_y * jump_y
+                side_y += jump_y * delta_y
+                depth += 1 + jump_x + jump_y
+                continue
+
+        reads += 1
+        depth += 1
+        if get_nibble(level, map_x, map_y) == 0xF:
+            break
+    return reads, steps
+
+
+def report(level, distance):
+    rays = [0, 0, 0, 0, 0]
+    for y in range(LEVEL_HEIGHT):
+        for x in range(LEVEL_WIDTH):
+            if get_nibble(level, x, y) not in EMPTY_BLOCKS:
+                continue
+            for i in range(32):
+                angle = 2 * math.pi * (i + 0.5) / 32
+                reads, steps = cast(level, distance, x + 0.5, y + 0.5, angle, False)
+                skip_reads, skip_steps = cast(level, distance, x + 0.5, y + 0.5, angle, True)
+                rays[0] += 1
+                rays[1] += reads
+                rays[2] += skip_reads
+                rays[3] += steps
+                rays[4] += skip_steps
+    print('rayos simulados: %d' % rays[0])
+    print('pasos del DDA por rayo: %.2f sin salto, %.2f con salto (%.0f%% menos)' % (
+        rays[3] / rays[0], rays[4] / rays[0], 100 - 100.0 * rays[4] / rays[3]))
+    print('lecturas por rayo: %.2f sin salto, %.2f con salto (%.0f%% menos)' % (
+        rays[1] / rays[0], rays[2] / rays[0], 100 - 100.0 * rays[2] / rays[1]))
+
+
+def main():
+    args = [a for a in sys.argv[1:] if not a.startswith('--')]
+    path = args[0] if args else os.path.join(os.path.dirname(__file__), '..', 'level.h')
+    with open(path, newline='') as f:
+        source = f.read()
+    newline = '\r\n' if '\r\n' in source else '\n'
+    source = source.replace('\r\n', '\n')
+
+    level = read_level(source)
+    distance = build_distance(level)
+    table = format_tables(pack(distance))
+
+    if BEGIN in source:
+        start = source.index(BEGIN)
+        end = source.index(END) + len(END)
+        updated = source[:start] + table + source[end:]
+    else:
+        anchor = source.index('\n', source.index('sto_level_1_objects =')) + 2
+        updated = source[:anchor] + '\n' + table + source[anchor:]
+
+    report(level, distance)
+
+    if '--check' in sys.argv:
+        if updated != source:
+            sys.exit('las tablas de level.h no están actualizadas; ejecuta tools/level_tables.py')
+        return
+
+    with open(path, 'w', newline='') as f:
+        f.write(updated.replace('\n', newline))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""
+Mide la imagen real del ATmega328P bajo simavr y guarda el resultado como referencia.
+
+Ejecuta los pasos de la sección AVR Benchmark del README: compila el sketch con BENCH_SIMAVR con
+arduino-cli, saca la tabla de símbolos con avr-nm, compila host/simavr_bench.c y lo ejecuta.
+Añade los tamaños de avr-size (flash y RAM estática) de la imagen de la medición y de la normal, y
+escribe todo en host/simavr_baseline.txt junto con el commit y las versiones de las herramientas,
+para comparar las mediciones de commits posteriores con la misma cadena de compilación.
+
+Necesita arduino-cli con el núcleo arduino:avr, avr-nm, avr-size, un compilador de C y simavr
+(cabeceras en /usr/include/simavr o en la ruta de --simavr).
+
+Uso: python3 tools/simavr_baseline.py [--simavr ruta/a/include/simavr] [--output fichero]
+"""
+import os
+import subprocess
+import sys
+
+ROOT = os.path.join(os.path.dirname(__file__), '..')
+FQBN = 'arduino:avr:uno'
+MCU = 'atmega328p'
+
+
+def run(command, **kwargs):
+    print('$ ' + ' '.join(command), file=sys.stderr)
+    try:
+        result = subprocess.run(command, cwd=ROOT, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                                universal_newlines=True, **kwargs)
+    except OSError:
+        sys.exit('no se encuentra %s' % command[0])
+    if result.returncode:
+        sys.exit(result.stdout + '\n%s terminó con el código %d' % (command[0], result.returncode))
+    return result.stdout
+
+
+def first_line(command):
+    try:
+        return run(command).splitlines()[0]
+    except (SystemExit, IndexError):
+        return '(desconocida)'
+
+
+def size(elf):
+    # -C resume flash y RAM del MCU; no todas las versiones de avr-size lo admiten
+    try:
+        return run(['avr-size', '-C', '--mcu=' + MCU, elf])
+    except SystemExit:
+        return run(['avr-size', elf])
+
+
+def option(name, default):
+    return sys.argv[sys.argv.index(name) + 1] if name in sys.argv else default
+
+
+def main():
+    include = option('--simavr', '/usr/include/simavr')
+    output = option('--output', os.path.join('host', 'simavr_baseline.txt'))
+    build = os.path.join('build', 'bench')
+    elf = os.path.join(build, 'doom.ino.elf')
+    symbols = os.path.join(build, 'doom.sym')
+
+    run(['arduino-cli', 'compile', '--fqbn', FQBN, '--build-property',
+         'compiler.cpp.extra_flags=-DBENCH_SIMAVR', '--output-dir', build])
+    with open(os.path.join(ROOT, symbols), 'w') as f:
+        f.write(run(['avr-nm', '-n', '-C', elf]))
+    run(['cc', '-O2', '-I' + include, os.path.join('host', 'simavr_bench.c'),
+         '-lsimavr', '-lelf', '-o', os.path.join(build, 'simavr_bench')])
+    bench = run([os.path.join(build, 'simavr_bench'), elf, symbols])
+
+    game_build = os.path.join('build', 'game')
+    run(['arduino-cli', 'compile', '--fqbn', FQBN, '--output-dir', game_build])
+
+    lines = [
+        'commit: ' + first_line(['git', 'rev-parse', '--short', 'HEAD']),
+        'arduino-cli: ' + first_line(['arduino-cli', 'version']),
+        'avr-gcc: ' + first_line(['avr-gcc', '--version']),
+        '',
+        '# avr-size, imagen normal',
+        size(os.path.join(game_build, 'doom.ino.elf')).rstrip(),
+        '',
+        '# avr-size, imagen de la medición (BENCH_SIMAVR)',
+        size(elf).rstrip(),
+        '',
+        '# simavr_bench',
+        bench.rstrip(),
+        '',
+    ]
+    with open(os.path.join(ROOT, output), 'w') as f:
+        f.write('\n'.join(lines))
+    print('\n'.join(lines))
+
+
+if __name__ == '__main__':
+    main()
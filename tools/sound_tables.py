@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+"""
+Genera en sound.h los efectos de sonido comprimidos a partir de assets/sounds.txt.
+
+sounds.txt tiene un efecto por bloque: una línea "nombre:" seguida de sus muestras en hexadecimal
+(formato Inverse Frequency Sound, una muestra por tick del timer 2, 0 es silencio); "#" empieza un
+comentario.
+
+Cada efecto se guarda como una secuencia de tramos, cada uno con un byte de control:
+  0x01 a 0x7F  la siguiente muestra se repite control veces
+  0x81 a 0xFF  siguen control & 0x7F muestras distintas
+  0x00         fin del efecto
+El ISR del timer 2 lee un tramo cada vez que se acaba el anterior, así que cada tick hace como
+mucho dos lecturas de flash; en las repeticiones no hace ninguna ni reprograma el timer 1. El
+codificador elige la secuencia de tramos más corta de cada efecto.
+
+Imprime el tamaño en flash de cada efecto sin comprimir y comprimido.
+
+Uso: python3 tools/sound_tables.py [ruta/a/sound.h] [--check]
+  --check  no modifica sound.h; termina con error si los efectos no están actualizados
+"""
+import os
+import sys
+
+ROOT = os.path.join(os.path.dirname(__file__), '..')
+
+LITERAL = 0x80
+MAX_COUNT = 0x7F
+
+BEGIN = '// Efectos comprimidos (generados por tools/sound_tables.py desde assets/sounds.txt, no editar)\n'
+END = '// Fin de los efectos generados\n'
+
+
+def read_sounds(path):
+    sounds = []
+    with open(path) as f:
+        for line in f:
+            line = line.split('#')[0].strip()
+            if not line:
+                continue
+            if line.endswith(':'):
+                sounds.append((line[:-1], []))
+            else:
+                sounds[-1][1].extend(int(v, 16) for v in line.split())
+    return sounds
+
+
+def encode(samples):
+    """Secuencia de tramos más corta, terminada en 0x00."""
+    n = len(samples)
+    # best[i]: bytes para codificar samples[i:]; choice[i]: (repetición, muestras del tramo)
+    best = [None] * n + [1]
+    choice = [None] * n
+    for i in range(n - 1, -1, -1):
+        end = i
+        while end < n and samples[end] == samples[i] and end - i < MAX_COUNT:
+            end += 1
+            if best[i] is None or 2 + best[end] < best[i]:
+                best[i], choice[i] = 2 + best[end], (True, end - i)
+
+        for end in range(i + 1, min(n, i + MAX_COUNT) + 1):
+            if 1 + end - i + best[end] < best[i]:
+                best[i], choice[i] = 1 + end - i + best[end], (False, end - i)
+
+    data = []
+    i = 0
+    while i < n:
+        repeat, count = choice[i]
+        if repeat:
+            data.extend((count, samples[i]))
+        else:
+            data.append(LITERAL | count)
+            data.extend(samples[i:i + count])
+        i += count
+    data.append(0)
+    return data
+
+
+def decode(data):
+    samples = []
+    i = 0
+    while data[i]:
+        count = data[i] & MAX_COUNT
+        if data[i] & LITERAL:
+            samples.extend(data[i + 1:i + 1 + count])
+            i += 1 + count
+        else:
+            samples.extend([data[i + 1]] * count)
+            i += 2
+    return samples
+
+
+def format_sound(name, samples, data):
+    lines = ['// %d muestras\n' % len(samples), 'constexpr uint8_t %s[] PROGMEM = {\n' % name]
+    for row in range(0, len(data), 16):
+        lines.append('  ' + ' '.join('0x%02x,' % v for v in data[row:row + 16]) + '\n')
+    lines.append('};\n')
+    return ''.join(lines)
+
+
+def main():
+    args = [a for a in sys.argv[1:] if not a.startswith('--')]
+    path = args[0] if args else os.path.join(ROOT, 'sound.h')
+    with open(path, newline='') as f:
+        source = f.read()
+    newline = '\r\n' if '\r\n' in source else '\n'
+    source = source.replace('\r\n', '\n')
+
+    blocks = []
+    raw_total = 0
+    total = 0
+    for name, samples in read_sounds(os.path.join(ROOT, 'assets', 'sounds.txt')):
+        data = encode(samples)
+        assert decode(data) == samples
+        blocks.append(format_sound(name, samples, data))
+        raw_total += len(samples)
+        total += len(data)
+        print('%-16s %3d bytes sin comprimir, %3d comprimido' % (name, len(samples), len(data)))
+    print('%-16s %3d bytes sin comprimir, %3d comprimido (%+.0f%%)' % (
+        'total', raw_total, total, 100.0 * total / raw_total - 100))
+
+    table = BEGIN + '\n' + '\n'.join(blocks) + END
+    start = source.index(BEGIN)
+    end = source.index(END) + len(END)
+    updated = source[:start] + table + source[end:]
+
+    if '--check' in sys.argv:
+        if updated != source:
+            sys.exit('los efectos de sound.h no están actualizados; ejecuta tools/sound_tables.py')
+        return
+
+    with open(path, 'w', newline='') as f:
+        f.write(updated.replace('\n', newline))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,252 @@
+#!/usr/bin/env python3
+"""
+Genera en sprites.h las hojas de sprites que dibuja drawSprites() (enemigo, objetos y bola de fuego)
+a partir de las imágenes de assets/, en formato por columnas con tramos.
+
+Cada hoja es una imagen con los sprites uno debajo de otro (ancho del sprite x alto * número):
+- PNG con canal alfa (escala de grises o RGB, 8 bits, sin entrelazar): alfa >= 128 es opaco y el
+  píxel opaco es blanco si su luminancia es >= 128.
+- PBM (P1 o P4) más una máscara <nombre>_mask.pbm: en las dos, negro (1) es el valor marcado; en la
+  imagen es el negro de la pantalla y en la máscara es opaco. Los píxeles sin máscara no se dibujan.
+Si existen las dos, se usa el PNG.
+
+Formato de cada columna (de arriba abajo): bytes de control tipo << 6 | longitud (1 a 63 filas)
+  0 transparente (el byte 0x00 termina la columna: el resto es transparente)
+  1 negro
+  2 blanco
+  3 opaco con los colores en los (longitud + 7) / 8 bytes siguientes, bit 7 primero (1 = blanco)
+Las columnas de cada sprite van seguidas y <hoja>_frames guarda dónde empieza cada sprite. El
+codificador elige por columna la secuencia de tramos más corta; los tramos de un solo color ganan a
+igual tamaño porque se dibujan sin leer bits.
+
+Imprime el tamaño en flash de cada hoja con mapa de bits y máscara (dos bytes por cada 8 píxeles)
+y con tramos.
+
+Uso: python3 tools/sprite_tables.py [ruta/a/sprites.h] [--check]
+  --check  no modifica sprites.h; termina con error si las hojas no están actualizadas
+"""
+import os
+import struct
+import sys
+import zlib
+
+ROOT = os.path.join(os.path.dirname(__file__), '..')
+
+# Hojas: nombre del fichero en assets/, prefijo en sprites.h y alto de cada sprite
+SHEETS = (
+    ('imp', 'BMP_IMP', 32),
+    ('fireball', 'BMP_FIREBALL', 16),
+    ('items', 'BMP_ITEMS', 16),
+)
+
+TRANSPARENT, BLACK, WHITE, LITERAL = range(4)
+MAX_RUN = 63
+
+BEGIN = '// Sprites por columnas (generados por tools/sprite_tables.py desde assets/, no editar)\n'
+END = '// Fin de los sprites generados\n'
+
+
+def read_pbm(path):
+    """Devuelve las filas de un PBM como listas de 0/1 (1 = negro)."""
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    tokens = []
+    position = 0
+    while len(tokens) < 3:
+        while data[position:position + 1].isspace():
+            position += 1
+        if data[position:position + 1] == b'#':
+            position = data.index(b'\n', position)
+            continue
+        start = position
+        while not data[position:position + 1].isspace():
+            position += 1
+        tokens.append(data[start:position].decode())
+    magic, width, height = tokens[0], int(tokens[1]), int(tokens[2])
+
+    if magic == 'P4':
+        position += 1
+        stride = (width + 7) // 8
+        return [[data[position + y * stride + x // 8] >> (7 - x % 8) & 1 for x in range(width)]
+                for y in range(height)]
+    if magic != 'P1':
+        sys.exit('%s: formato PBM no soportado (%s)' % (path, magic))
+
+    pixels = []
+    for line in data[position:].decode().splitlines():
+        pixels.extend(int(c) for c in line.split('#')[0] if c in '01')
+    return [pixels[y * width:(y + 1) * width] for y in range(height)]
+
+
+def read_png(path):
+    """Devuelve las filas de un PNG como listas de (luminancia, alfa)."""
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[:8] != b'\x89PNG\r\n\x1a\n':
+        sys.exit('%s: no es un PNG' % path)
+
+    position = 8
+    compressed = b''
+    while position < len(data):
+        length, kind = struct.unpack('>I4s', data[position:position + 8])
+        chunk = data[position + 8:position + 8 + length]
+        if kind == b'IHDR':
+            width, height, depth, color, _, _, interlace = struct.unpack('>IIBBBBB', chunk)
+        elif kind == b'IDAT':
+            compressed += chunk
+        position += 12 + length
+
+    channels = {0: 1, 2: 3, 4: 2, 6: 4}.get(color)
+    if depth != 8 or interlace or channels is None:
+        sys.exit('%s: se necesita un PNG de 8 bits sin paleta ni entrelazado' % path)
+
+    raw = zlib.decompress(compressed)
+    stride = width * channels
+    rows = []
+    previous = bytearray(stride)
+    for y in range(height):
+        kind = raw[y * (stride + 1)]
+        row = bytearray(raw[y * (stride + 1) + 1:(y + 1) * (stride + 1)])
+        for i in range(stride):
+            left = row[i - channels] if i >= channels else 0
+            up = previous[i]
+            up_left = previous[i - channels] if i >= channels else 0
+            if kind == 1:
+                row[i] = (row[i] + left) & 0xFF
+            elif kind == 2:
+                row[i] = (row[i] + up) & 0xFF
+            elif kind == 3:
+                row[i] = (row[i] + (left + up) // 2) & 0xFF
+            elif kind == 4:
+                estimate = left + up - up_left
+                pa, pb, pc = abs(estimate - left), abs(estimate - up), abs(estimate - up_left)
+                predictor = left if pa <= pb and pa <= pc else up if pb <= pc else up_left
+                row[i] = (row[i] + predictor) & 0xFF
+        previous = row
+
+        pixels = []
+        for x in range(width):
+            p = row[x * channels:(x + 1) * channels]
+            luminance = p[0] if channels < 3 else (299 * p[0] + 587 * p[1] + 114 * p[2]) // 1000
+            alpha = p[-1] if channels in (2, 4) else 255
+            pixels.append((luminance, alpha))
+        rows.append(pixels)
+    return rows
+
+
+def read_sheet(name):
+    """Devuelve la hoja como filas de TRANSPARENT, BLACK o WHITE."""
+    base = os.path.join(ROOT, 'assets', name)
+    if os.path.exists(base + '.png'):
+        return [[(WHITE if luminance >= 128 else BLACK) if alpha >= 128 else TRANSPARENT
+                 for luminance, alpha in row] for row in read_png(base + '.png')]
+
+    image = read_pbm(base + '.pbm')
+    mask = read_pbm(base + '_mask.pbm')
+    if len(image) != len(mask) or len(image[0]) != len(mask[0]):
+        sys.exit('%s: la máscara no tiene el tamaño de la imagen' % name)
+    return [[(BLACK if black else WHITE) if opaque else TRANSPARENT
+             for black, opaque in zip(image_row, mask_row)] for image_row, mask_row in zip(image, mask)]
+
+
+def encode_column(column):
+    """Secuencia de tramos más corta de una columna, terminada en 0x00."""
+    while column and column[-1] == TRANSPARENT:
+        column = column[:-1]
+
+    n = len(column)
+    # best[i]: (bytes, tramos con bits) para codificar column[i:]; choice[i]: (tipo, longitud)
+    best = [None] * n + [(1, 0)]
+    choice = [None] * n
+    for i in range(n - 1, -1, -1):
+        end = i
+        while end < n and column[end] == column[i] and end - i < MAX_RUN:
+            end += 1
+            cost = (1 + best[end][0], best[end][1])
+            if best[i] is None or cost < best[i]:
+                best[i], choice[i] = cost, (column[i], end - i)
+
+        end = i
+        while end < n and column[end] != TRANSPARENT and end - i < MAX_RUN:
+            end += 1
+            cost = (1 + (end - i + 7) // 8 + best[end][0], 1 + best[end][1])
+            if cost < best[i]:
+                best[i], choice[i] = cost, (LITERAL, end - i)
+
+    data = []
+    i = 0
+    while i < n:
+        kind, length = choice[i]
+        data.append(kind << 6 | length)
+        if kind == LITERAL:
+            bits = [column[i + k] == WHITE for k in range(length)]
+            for k in range(0, length, 8):
+                data.append(sum(1 << (7 - b) for b in range(8) if k + b < length and bits[k + b]))
+        i += length
+    data.append(0)
+    return data
+
+
+def encode_sheet(pixels, height):
+    width = len(pixels[0])
+    if len(pixels) % height:
+        sys.exit('el alto de la hoja no es múltiplo de %d' % height)
+
+    data = []
+    frames = []
+    for top in range(0, len(pixels), height):
+        frames.append(len(data))
+        for x in range(width):
+            data.extend(encode_column([pixels[top + y][x] for y in range(height)]))
+    return width, frames, data
+
+
+def format_sheet(prefix, height, width, frames, data):
+    name = prefix.lower()
+    lines = ['#define %-20s %d\n' % (prefix + '_WIDTH', width),
+             '#define %-20s %d\n' % (prefix + '_HEIGHT', height),
+             '#define %-20s %d\n' % (prefix + '_COUNT', len(frames)),
+             'const static uint16_t %s_frames[] PROGMEM = { %s };\n' % (name, ', '.join(str(f) for f in frames)),
+             'const static uint8_t %s_spans[] PROGMEM = {\n' % name]
+    for row in range(0, len(data), 16):
+        lines.append('  ' + ' '.join('0x%02x,' % v for v in data[row:row + 16]) + '\n')
+    lines.append('};\n')
+    return ''.join(lines)
+
+
+def main():
+    args = [a for a in sys.argv[1:] if not a.startswith('--')]
+    path = args[0] if args else os.path.join(ROOT, 'sprites.h')
+    with open(path, newline='') as f:
+        source = f.read()
+    newline = '\r\n' if '\r\n' in source else '\n'
+    source = source.replace('\r\n', '\n')
+
+    blocks = []
+    for file_name, prefix, height in SHEETS:
+        pixels = read_sheet(file_name)
+        width, frames, data = encode_sheet(pixels, height)
+        blocks.append(format_sheet(prefix, height, width, frames, data))
+
+        bitmap_size = 2 * width * len(pixels) // 8
+        span_size = len(data) + 2 * len(frames)
+        print('%-9s %2d sprites de %dx%d: %4d bytes con mapa de bits y máscara, %4d con tramos (%+.0f%%)' % (
+            file_name, len(frames), width, height, bitmap_size, span_size, 100.0 * span_size / bitmap_size - 100))
+
+    table = BEGIN + '\n' + '\n'.join(blocks) + END
+    start = source.index(BEGIN)
+    end = source.index(END) + len(END)
+    updated = source[:start] + table + source[end:]
+
+    if '--check' in sys.argv:
+        if updated != source:
+            sys.exit('los sprites de sprites.h no están actualizados; ejecuta tools/sprite_tables.py')
+        return
+
+    with open(path, 'w', newline='') as f:
+        f.write(updated.replace('\n', newline))
+
+
+if __name__ == '__main__':
+    main()
@@ -24,6 +24,56 @@ struct Coords {
   double y;
 };
 
+// Result of casting one ray in renderMap()
+struct RayHit {
+  double distance;     // perpendicular distance to the wall (not clamped)
+  double wall;         // hit coordinate along the wall, in cells (TEXTURED_WALLS only)
+  uint8_t map_x;       // cell that was hit
+  uint8_t map_y;
+  uint8_t door_offset; // opening of the door that was hit
+  bool hit;
+  bool side;           // 0: x face, 1: y face
+  bool door;
+  bool flip;           // face seen from the side that mirrors the texture
+};
+
+// Camera of one frame: player pose and the inverse determinant of the view transform
+struct Camera {
+  Coords pos;
+  Coords dir;
+  Coords plane;
+  double inv_det;      // 1 / (plane.x * dir.y - dir.x * plane.y)
+};
+
+// Entity in view space, cached by updateViewCache() for the entity at the same index of GameState::entity.
+// Fixed point keeps an entry at 6 bytes; depth 0 marks an entity behind the camera (depth <= 0.1)
+struct EntityView {
+  int16_t screen_x;    // screen column of the sprite centre
+  uint16_t depth;      // distance along the view axis (transform y), VIEW_DEPTH_SHIFT fraction bits
+  uint16_t scale;      // 1 / depth, scale of the sprite, VIEW_SCALE_SHIFT fraction bits
+};
+
+// Wall column as drawn by drawColumn(), kept by COLUMN_CACHE to redraw it without casting.
+// Coord is the coordinate type of the render configuration (int8_t on the 128x64 screen)
+template <class Coord>
+struct WallColumnOf {
+  Coord start_y;       // render height when the ray hit nothing
+  Coord end_y;
+  uint8_t intensity;
+#ifdef TEXTURED_WALLS
+  uint8_t texture;     // texture index << 5 | texture column
+#endif
+};
+
+typedef WallColumnOf<int8_t> WallColumn;
+
+// Entity cell of a level: listed by level_compiler.h, or crossed by a ray and queued by the threaded host renderer (HOST_BUILD)
+struct SpawnCell {
+  uint8_t block;
+  uint8_t x;
+  uint8_t y;
+};
+
 UID create_uid(EType type, uint8_t x, uint8_t y);
 EType uid_get_type(UID uid);
 